@@ -0,0 +1,49 @@
+/*
+ * Moteur de simulation par lots : un pool de threads joue en parallèle
+ * un grand nombre de parties indépendantes (une `EtatJeu` par partie),
+ * pilotées par une politique d'entrée automatique. Sert à l'équilibrage
+ * et à l'évaluation de bots.
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "model.h"
+#include "simulation.h"
+
+typedef struct {
+    int nb_threads;          /* taille du pool (<= 0 : nombre de cœurs) */
+    long nb_parties;         /* nombre total de parties à jouer */
+    long ticks_max_partie;   /* garde-fou : une partie est arrêtée après N ticks (0 = sans limite) */
+    TypePolitique politique;
+    const char* script;
+    unsigned int graine;     /* la partie i utilise la graine `graine + i` */
+    ConfigJeu jeu;           /* terrain, vague et capacités de chaque partie */
+} ConfigBatch;
+
+typedef struct {
+    long parties;
+    long long ticks;
+    long long score_total;
+    long vols;               /* parties prises dans la file d'un autre thread */
+    long echecs;             /* parties dont l'état n'a pas pu être créé */
+    uint64_t duree_ns;
+} ResultatBatch;
+
+/* Remplit `c` avec les valeurs par défaut (1000 parties, tous les cœurs). */
+void batch_config_defaut(ConfigBatch* c);
+
+/* Joue toutes les parties avec le pool de threads.
+ * @return 0 si succès, >0 en cas d'erreur (création des threads, mémoire,
+ * ou une partie dont l'état n'a pas pu être créé, comptée dans `echecs`).
+ */
+int batch_executer(const ConfigBatch* c, ResultatBatch* out);
+
+/* Mode `--view=batch` : exécute le lot, ou mesure la montée en charge
+ * de 1 à `nb_threads` threads si `echelle` est non nul, et imprime le rapport.
+ */
+int vue_batch_executer(const ConfigBatch* c, int echelle);
+
+/* Nombre de cœurs disponibles (au moins 1). */
+int batch_nombre_coeurs(void);
+
+#endif /* BATCH_H */
@@ -0,0 +1,51 @@
+/*
+ * Cadence des images des vues interactives (console, ANSI, SDL3), à
+ * échéances absolues : l'image n doit commencer à `debut + n * periode`,
+ * quelle que soit la durée du travail de chaque image, ce qui évite la
+ * dérive d'un sommeil de durée fixe après le travail. L'attente dort
+ * jusqu'à un peu avant l'échéance (`clock_nanosleep` avec TIMER_ABSTIME,
+ * `nanosleep` relatif sous macOS, qui n'a pas `clock_nanosleep`),
+ * puis finit en boucle active sur l'horloge monotone pour une précision
+ * inférieure à la milliseconde. La marge de boucle active suit le retard
+ * de réveil observé du sommeil.
+ */
+#ifndef CADENCE_H
+#define CADENCE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "simulation.h"
+
+/* Bornes de la marge de boucle active (ns) */
+#define CADENCE_MARGE_MIN 20000ull
+#define CADENCE_MARGE_MAX 2000000ull
+
+typedef struct {
+    uint64_t periode;        /* ns entre deux échéances */
+    uint64_t echeance;       /* prochaine échéance (horloge_ns) */
+    uint64_t marge;          /* fin d'attente en boucle active (ns) */
+    uint64_t retard_reveil;  /* moyenne glissante du retard de réveil du sommeil (ns) */
+    HistogrammeLatence ecart; /* écart entre l'échéance et la fin de l'attente (ns) */
+    long images;
+    long en_retard;          /* images dont le travail a dépassé l'échéance */
+    long sautees;            /* échéances abandonnées après un retard de plus d'une période */
+} Cadence;
+
+/* Démarre la cadence : première échéance une période après maintenant. */
+void cadence_demarrer(Cadence* c, int images_par_seconde);
+
+/* Attend l'échéance de l'image courante et passe à la suivante. Une image
+ * en retard n'attend pas ; si le retard dépasse une période, les échéances
+ * manquées sont abandonnées au lieu d'être rattrapées d'un coup.
+ * @return temps attendu (ns).
+ */
+uint64_t cadence_attendre(Cadence* c);
+
+/* Repart de maintenant après une attente hors cadence (pause, game over),
+ * sans compter de retard. */
+void cadence_recaler(Cadence* c);
+
+/* Imprime sur `f` une ligne de statistiques préfixée par `nom`. */
+void cadence_rapport(const Cadence* c, const char* nom, FILE* f);
+
+#endif /* CADENCE_H */
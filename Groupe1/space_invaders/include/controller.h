@@ -10,10 +10,60 @@ typedef enum Commande {
     CMD_DROITE,  /* déplacer vaisseau vers la droite */
     CMD_TIRER,   /* tirer un projectile */
     CMD_PAUSE,   /* pause (gérée par la vue) */
-    CMD_QUITTER  /* quitter le jeu */
+    CMD_QUITTER, /* quitter le jeu */
+    CMD_RECOMMENCER /* recommencer la partie depuis son état initial */
 } Commande;
 
 /* Applique une commande donnée sur l'état du jeu. */
 void controleur_appliquer_commande(EtatJeu* e, Commande c);
 
+/*
+ * Entrées par tick : à chaque image, la vue lit toutes les entrées en
+ * attente et les résume dans un `EntreesTick` (touches maintenues et
+ * touches appuyées depuis le tick précédent). Le contrôleur les applique
+ * une fois au début de chaque tick de simulation : un appui déplace ou tire
+ * tout de suite, une touche maintenue répète à cadence fixe en ticks. Les
+ * touches accumulées dans le tampon du terminal ne sont donc jamais jouées
+ * en retard, et la même suite d'entrées donne la même partie quelle que
+ * soit la cadence d'affichage. La pause, quitter et recommencer restent
+ * traités par la vue.
+ */
+#define ENTREE_GAUCHE 0x01
+#define ENTREE_DROITE 0x02
+#define ENTREE_TIRER 0x04
+#define ENTREE_PAUSE 0x08 /* front seulement : la vue bascule la pause */
+
+/* Ticks entre deux répétitions d'une touche maintenue */
+#define REPETITION_DEPLACEMENT 4 /* 15 cases/s */
+#define REPETITION_TIR 6         /* 10 tirs/s */
+
+typedef struct {
+    unsigned maintenues; /* ENTREE_* enfoncées */
+    unsigned appuyees;   /* ENTREE_* enfoncées depuis le dernier tick, même si déjà relâchées */
+    int attente_gauche, attente_droite, attente_tir; /* ticks depuis la dernière action */
+} EntreesTick;
+
+/* Terminaux (pas d'événement de relâchement) : `vues` sont les touches lues
+ * pendant l'image. Elles deviennent les touches maintenues, et celles qui
+ * ne l'étaient pas à l'image précédente sont ajoutées aux appuis. */
+void controleur_entrees_image(EntreesTick* t, unsigned vues);
+
+/* Oublie les touches maintenues et les appuis en attente (pause, perte de focus). */
+void controleur_entrees_vider(EntreesTick* t);
+
+/* Exécute les ticks dus pour `dt_reel` secondes (voir `etatjeu_avancer`),
+ * en appliquant `t` au début de chaque tick ; les appuis sont consommés
+ * par le premier tick. Les actions passent par `controleur_appliquer_commande`
+ * et sont donc enregistrées avec leur tick.
+ * @return nombre de ticks exécutés.
+ */
+int controleur_avancer(EtatJeu* e, EntreesTick* t, double dt_reel);
+
+/* Enregistreur de rejeu (voir rejeu.h) : tant qu'il est défini, chaque
+ * commande appliquée à `cible` y est écrite avec son tick, avant d'être
+ * appliquée. NULL arrête l'enregistrement. Les autres parties (threads du
+ * mode batch) ne sont pas enregistrées. */
+struct Enregistreur;
+void controleur_definir_enregistreur(struct Enregistreur* r, const EtatJeu* cible);
+
 #endif /* CONTROLLER_H */
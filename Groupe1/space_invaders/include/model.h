@@ -1,23 +1,119 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 typedef struct EtatJeu EtatJeu;
 
+/* Capacités par défaut des réserves d'entités (voir `ConfigJeu`) */
+#define NB_MAX_ENNEMIS 64
+#define NB_MAX_PROJECTILES 128
+#define NB_MAX_BOUCLIERS 4
+#define NB_MAX_PARTICULES 256
+
+/* Bornes acceptées par `etatjeu_config_erreur` */
+#define CONFIG_LARGEUR_MIN 8
+#define CONFIG_HAUTEUR_MIN 8
+#define CONFIG_DIMENSION_MAX 10000
+#define CONFIG_CAPACITE_MAX 1000000
+
+/* Choix du tireur ennemi, vague par vague. Seul l'ennemi vivant le plus bas
+ * d'une colonne peut tirer (il ne tire jamais à travers la formation). */
+#define TIR_ALEATOIRE 0 /* une colonne au hasard */
+#define TIR_VISE 1      /* la colonne la plus proche du vaisseau */
+#define TIR_RAFALE 2    /* une colonne au hasard, qui tire plusieurs fois de suite */
+#define TIR_ALTERNE 3   /* les trois précédentes tour à tour : vague 1 aléatoire, 2 visée, 3 rafale... */
+
+/* Paramètres d'une partie, fixés à la création : dimensions du terrain,
+ * disposition de chaque vague et capacités des réserves. L'état et tous ses
+ * tableaux sont alloués une seule fois, en un bloc, à partir de ces valeurs.
+ */
+typedef struct {
+    int largeur;          /* colonnes du terrain (défaut 80) */
+    int hauteur;          /* lignes du terrain (défaut 24) */
+    int vague_lignes;     /* lignes d'ennemis par vague (défaut 3) */
+    int vague_colonnes;   /* colonnes d'ennemis par vague (défaut 8) */
+    int max_ennemis;      /* capacités (défauts NB_MAX_*) ; une vague plus grande est tronquée */
+    int max_projectiles;
+    int max_particules;
+    int politique_tir;    /* TIR_* (défaut TIR_ALEATOIRE) */
+} ConfigJeu;
+
+/* Remplit `c` avec la configuration par défaut (80 x 24, vague 3 x 8). */
+void etatjeu_config_defaut(ConfigJeu* c);
+
+/* Politique de tir d'après son nom ("random", "aimed", "burst", "cycle").
+ * @return TIR_*, ou -1 si le nom est inconnu.
+ */
+int etatjeu_politique_tir_depuis_nom(const char* nom);
+
+/* Vérifie une configuration.
+ * @return NULL si elle est utilisable, sinon un message d'erreur statique.
+ */
+const char* etatjeu_config_erreur(const ConfigJeu* c);
+
+/* Crée une partie selon `c`, avec la graine `graine`.
+ * @return NULL si la configuration est invalide ou si l'allocation échoue.
+ */
+EtatJeu* etatjeu_creer_config(const ConfigJeu* c, uint64_t graine);
+
 /* Crée et initialise l'état du jeu.
+ * Chaque état possède son propre générateur aléatoire et aucun état global :
+ * des instances distinctes peuvent être mises à jour depuis des threads différents.
  * @param largeur : largeur du terrain de jeu en colonnes.
  * @param hauteur : hauteur du terrain de jeu en lignes.
- * @return pointeur vers un `EtatJeu` initialisé ou NULL en cas d'erreur.
+ * Les autres paramètres sont ceux de `etatjeu_config_defaut`.
+ * @return pointeur vers un `EtatJeu` initialisé ou NULL en cas d'erreur
+ *         (mémoire, ou dimensions refusées par `etatjeu_config_erreur`).
  */
 EtatJeu* etatjeu_creer(int largeur, int hauteur);
 
+/* Comme `etatjeu_creer`, mais avec une graine explicite pour le générateur
+ * aléatoire de la partie (tirs ennemis, santé des ennemis). Deux parties de
+ * même graine recevant les mêmes commandes aux mêmes ticks (même `dt`)
+ * évoluent de façon strictement identique.
+ */
+EtatJeu* etatjeu_creer_avec_graine(int largeur, int hauteur, uint64_t graine);
+
 /* Libère les ressources associées à l'état du jeu. */
 void etatjeu_detruire(EtatJeu* e);
 
-/* Met à jour l'état du jeu.
- * @param dt : temps écoulé (en secondes) depuis la dernière mise à jour.
+/* Pas de simulation fixe : chaque tick représente 1/60 s de jeu, quelle que
+ * soit la fréquence d'affichage de la vue. */
+#define PAS_FIXE (1.0 / 60.0)
+/* Ticks au plus par appel à `etatjeu_avancer` (garde-fou contre la spirale :
+ * une image en retard ne déclenche jamais plus de 8 ticks). */
+#define TICKS_MAX_PAR_IMAGE 8
+
+/* Exécute un tick de simulation. Projectiles et particules avancent d'un pas
+ * et les tirs ennemis sont tirés une fois par appel, quel que soit `dt` :
+ * seul le minuteur de marche de la formation utilise `dt`. Les vues passent
+ * par `etatjeu_avancer` ; cette fonction reste l'appel de bas niveau.
+ * @param dt : durée du tick (en secondes).
  */
 void etatjeu_mettre_a_jour(EtatJeu* e, double dt);
 
+/* Un tick de durée PAS_FIXE. */
+void etatjeu_tick(EtatJeu* e);
+
+/* Ajoute `dt_reel` secondes au temps à simuler et exécute autant de ticks
+ * fixes qu'il en contient (au plus TICKS_MAX_PAR_IMAGE, et aucun après le
+ * game over). Le reste est conservé pour l'appel suivant.
+ * @return nombre de ticks exécutés.
+ */
+int etatjeu_avancer(EtatJeu* e, double dt_reel);
+
+/* Comme `etatjeu_avancer`, en appelant `avant_tick(e, contexte)` au début
+ * de chaque tick exécuté (le contrôleur y applique les entrées du tick). */
+typedef void (*AvantTick)(EtatJeu* e, void* contexte);
+int etatjeu_avancer_avec(EtatJeu* e, double dt_reel, AvantTick avant_tick, void* contexte);
+
+/* Fraction du pas suivant déjà écoulée, dans [0, 1) : les vues dessinent
+ * chaque entité en `position - deplacement * (1 - alpha)` pour un rendu
+ * fluide entre deux ticks. */
+double etatjeu_alpha(const EtatJeu* e);
+
 /* Actions du vaisseau */
 /* Déplace le vaisseau : dir = -1 gauche, 1 droite */
 void etatjeu_deplacer_vaisseau(EtatJeu* e, int dir);
@@ -27,18 +123,98 @@ void etatjeu_vaisseau_tirer(EtatJeu* e);
 /* Accesseurs simples */
 int etatjeu_obtenir_vaisseau_x(const EtatJeu* e);
 int etatjeu_obtenir_largeur(const EtatJeu* e);
+int etatjeu_obtenir_hauteur(const EtatJeu* e);
+/* Copie dans `c` la configuration avec laquelle la partie a été créée. */
+void etatjeu_obtenir_config(const EtatJeu* e, ConfigJeu* c);
 int etatjeu_obtenir_vies(const EtatJeu* e);
 int etatjeu_obtenir_score(const EtatJeu* e);
 int etatjeu_obtenir_niveau(const EtatJeu* e);
 int etatjeu_devrait_quitter(const EtatJeu* e);
 int etatjeu_est_game_over(const EtatJeu* e);
+uint64_t etatjeu_obtenir_graine(const EtatJeu* e);
+/* Nombre de ticks exécutés depuis le début de la partie (remis à 0 par etatjeu_reinitialiser). */
+uint64_t etatjeu_obtenir_tick(const EtatJeu* e);
+/* Recommence la partie depuis son état initial. La nouvelle graine est tirée
+ * du générateur en cours (voir `etatjeu_obtenir_graine`) : la partie suivante
+ * diffère, mais reste reproductible à partir de la graine de départ. */
 void etatjeu_reinitialiser(EtatJeu* e);
 
-/* Constantes limites */
-#define NB_MAX_ENNEMIS 64
-#define NB_MAX_PROJECTILES 128
-#define NB_MAX_BOUCLIERS 4
-#define NB_MAX_PARTICULES 256
+/*
+ * Sauvegarde de l'état complet (générateur aléatoire compris) dans un blob
+ * binaire versionné et compact : seuls les projectiles et particules actifs
+ * sont écrits, la formation l'est sous forme de masque de vie, et les cases
+ * des boucliers, fixées par la configuration, ne le sont pas : la
+ * restauration ne touche leur grille d'occupation que pour ceux qui changent
+ * d'état. Le format est celui de la machine (boutisme, doubles) ; le magic
+ * lu sur une machine de boutisme différent ne correspond pas et le blob est
+ * refusé.
+ */
+#define SAUVEGARDE_MAGIC 0x564E4953u /* "SINV" */
+#define SAUVEGARDE_VERSION 4
+
+/* Taille maximale d'un blob pour cette partie (toutes réserves pleines) :
+ * un tampon de cette taille convient à toutes les sauvegardes de la partie. */
+size_t etatjeu_sauvegarde_taille_max(const EtatJeu* e);
+
+/* Écrit l'état de `e` dans `buf`.
+ * @return nombre d'octets écrits, 0 si `capacite` est insuffisante.
+ */
+size_t etatjeu_sauver(const EtatJeu* e, void* buf, size_t capacite);
+
+/* Remet `e` dans l'état sauvegardé. La partie doit avoir la même `ConfigJeu`
+ * que celle du blob. Le drapeau quitter et le temps en attente de
+ * `etatjeu_avancer` (état de la vue, non sauvegardés) sont remis à zéro.
+ * @return 0 si succès, 1 si le blob est invalide (`e` n'est alors pas modifié).
+ */
+int etatjeu_restaurer(EtatJeu* e, const void* buf, size_t taille);
+
+/* Crée une partie à partir d'un blob, avec la configuration qu'il contient.
+ * @return NULL si le blob est invalide ou si l'allocation échoue.
+ */
+EtatJeu* etatjeu_creer_depuis_sauvegarde(const void* buf, size_t taille);
+
+/*
+ * Événements : chaque tick ajoute ce qui s'y est passé dans un anneau de
+ * taille fixe, interne à la partie (aucune allocation). Chaque consommateur
+ * (vue, son, télémétrie...) garde son propre curseur et lit les événements
+ * parus depuis sa dernière lecture, au lieu de comparer l'état d'une image
+ * à l'autre. Un consommateur en retard de plus de EVENEMENTS_CAPACITE
+ * événements perd les plus anciens ; ils sont comptés dans son curseur.
+ * Les événements ne font pas partie de la sauvegarde, et
+ * `etatjeu_reinitialiser` ne vide pas l'anneau : les curseurs restent valides.
+ */
+#define EVENEMENTS_CAPACITE 256 /* puissance de deux */
+
+typedef enum {
+    EVT_ENNEMI_TUE,      /* detail : TYPE_ENNEMI_* ; valeur : score après la mort */
+    EVT_BOUCLIER_TOUCHE, /* detail : santé restante (0 = détruit) */
+    EVT_JOUEUR_TOUCHE,   /* detail : vies restantes */
+    EVT_VAGUE_TERMINEE,  /* valeur : niveau de la nouvelle vague */
+    EVT_GAME_OVER,       /* valeur : score final */
+    EVT_NOMBRE_TYPES
+} TypeEvenement;
+
+typedef struct {
+    uint64_t tick;  /* tick du modèle pendant lequel l'événement a eu lieu */
+    int32_t valeur;
+    int16_t x, y;   /* case concernée (0, 0 pour la vague et le game over) */
+    uint8_t type;   /* TypeEvenement */
+    uint8_t detail;
+} Evenement;
+
+typedef struct {
+    uint64_t position; /* numéro du prochain événement à lire */
+    uint64_t perdus;   /* événements écrasés avant d'avoir été lus */
+} CurseurEvenements;
+
+/* Place `c` sur l'événement courant : seuls les événements suivants seront lus. */
+void etatjeu_evenements_suivre(const EtatJeu* e, CurseurEvenements* c);
+
+/* Copie dans `dst` au plus `max` événements parus depuis la dernière lecture
+ * de `c`, dans l'ordre, et avance le curseur.
+ * @return nombre d'événements copiés (0 si aucun n'est en attente).
+ */
+int etatjeu_evenements_lire(const EtatJeu* e, CurseurEvenements* c, Evenement* dst, int max);
 
 /* Constantes pour les types d'entités */
 #define TYPE_JOUEUR 0
@@ -53,6 +229,8 @@ int etatjeu_obtenir_ennemi_y(const EtatJeu* e, int idx);
 int etatjeu_ennemi_vivant(const EtatJeu* e, int idx);
 int etatjeu_obtenir_ennemi_sante(const EtatJeu* e, int idx);
 
+/* Projectiles et particules : les indices [0, nombre) désignent exactement les
+ * entités actives (accès en O(1)). L'ordre peut changer d'un tick à l'autre. */
 int etatjeu_obtenir_nombre_projectiles(const EtatJeu* e);
 int etatjeu_obtenir_projectile_x(const EtatJeu* e, int idx);
 int etatjeu_obtenir_projectile_y(const EtatJeu* e, int idx);
@@ -71,4 +249,99 @@ int etatjeu_obtenir_particule_y(const EtatJeu* e, int idx);
 int etatjeu_obtenir_particule_type(const EtatJeu* e, int idx);
 int etatjeu_obtenir_particule_ttl(const EtatJeu* e, int idx);
 
+/*
+ * Capture pour le rendu : une copie compacte de tout ce qu'une vue dessine,
+ * remplie en une seule passe par `etatjeu_capturer`. Les tableaux appartiennent
+ * à l'appelant (voir `etatjeu_capture_allouer`) et ne contiennent que les
+ * entités visibles : ennemis et boucliers vivants, projectiles actifs,
+ * particules dont le ttl est positif.
+ */
+typedef struct {
+    int16_t x, y;
+    uint8_t type;   /* ennemi : TYPE_ENNEMI_* ; projectile : 0=joueur,1=ennemi ; particule : type d'origine */
+    uint8_t valeur; /* ennemi / bouclier : santé ; particule : ttl ; projectile : 0 */
+    int8_t dx, dy;  /* déplacement pendant le dernier tick (0 pour une entité créée depuis) */
+} EntiteRendu;
+
+typedef struct {
+    EntiteRendu* ennemis;     int nb_ennemis;     int cap_ennemis;
+    EntiteRendu* projectiles; int nb_projectiles; int cap_projectiles;
+    EntiteRendu* boucliers;   int nb_boucliers;   int cap_boucliers;
+    EntiteRendu* particules;  int nb_particules;  int cap_particules;
+    int largeur, hauteur;
+    int vaisseau_x, vaisseau_y;
+    int vies, score, niveau;
+    int game_over;
+    double alpha;   /* etatjeu_alpha au moment de la capture */
+} RenderSnapshot;
+
+/* Alloue les tableaux de `s` aux capacités de la partie `e`.
+ * @return 0 si succès, 1 en cas d'échec (rien n'est alloué).
+ */
+int etatjeu_capture_allouer(RenderSnapshot* s, const EtatJeu* e);
+
+/* Libère les tableaux alloués par `etatjeu_capture_allouer`. */
+void etatjeu_capture_liberer(RenderSnapshot* s);
+
+/* Copie l'état visible de `e` dans `s`, en une passe sur chaque catégorie.
+ * Une catégorie plus nombreuse que la capacité du tableau correspondant est tronquée.
+ */
+void etatjeu_capturer(const EtatJeu* e, RenderSnapshot* s);
+
+/*
+ * Calque de rendu et cases modifiées : à la demande d'une vue, le modèle
+ * tient un calque du terrain (un code CASE_* par case, dans l'ordre de
+ * dessin des vues : le vaisseau recouvre une particule, qui recouvre un
+ * bouclier...) et note les cases dont le code a changé dans un bitmap par
+ * case et un bitmap par ligne. Une vue en mode caractère ne redessine alors
+ * que ces cases, lues par plages de cases consécutives d'une même ligne.
+ *
+ * `etatjeu_calque_actualiser` ne repasse que sur les cases occupées avant
+ * l'appel et après : son coût suit le nombre d'entités, pas la surface du
+ * terrain, et lire les plages coûte un mot de 64 bits par ligne modifiée.
+ * Le calque n'est alloué qu'au premier appel (les parties sans vue, comme
+ * celles du mode batch, ne paient rien) et ne fait pas partie de la
+ * sauvegarde : après une restauration ou etatjeu_reinitialiser, l'appel
+ * suivant marque simplement tout ce qui a changé.
+ */
+#define CASE_VIDE 0
+#define CASE_ENNEMI 1
+#define CASE_TIR_JOUEUR 2
+#define CASE_TIR_ENNEMI 3
+#define CASE_BOUCLIER 4
+#define CASE_PARTICULE 5
+#define CASE_VAISSEAU 6
+#define CASE_ENNEMI_FORT 7 /* ennemi de santé >= 2 */
+#define CASE_NOMBRE_CODES 8
+
+typedef struct {
+    int y;      /* ligne */
+    int x0, x1; /* cases [x0, x1) */
+} PlageModifiee;
+
+typedef struct {
+    int y, x;   /* prochaine case à examiner (0, 0 pour commencer) */
+} CurseurPlages;
+
+/* Met le calque à jour d'après l'état courant et ajoute aux cases modifiées
+ * celles dont le code a changé depuis l'appel précédent. Au premier appel,
+ * toutes les cases occupées sont marquées.
+ * @return nombre de cases modifiées en attente (depuis le dernier
+ *         `etatjeu_calque_acquitter`), -1 si l'allocation du calque échoue.
+ */
+long etatjeu_calque_actualiser(EtatJeu* e);
+
+/* Codes CASE_* du calque, ligne par ligne (largeur x hauteur), tels qu'au
+ * dernier `etatjeu_calque_actualiser` ; NULL avant le premier appel. */
+const uint8_t* etatjeu_calque(const EtatJeu* e);
+
+/* Plage suivante de cases modifiées, lignes croissantes puis cases
+ * croissantes, à partir de `c` (mis à zéro pour commencer), qui est avancé.
+ * @return 1 si une plage a été écrite dans `p`, 0 s'il n'y en a plus.
+ */
+int etatjeu_plage_suivante(const EtatJeu* e, CurseurPlages* c, PlageModifiee* p);
+
+/* Vide les cases modifiées, une fois la vue à jour (en O(lignes modifiées)). */
+void etatjeu_calque_acquitter(EtatJeu* e);
+
 #endif /* MODEL_H */
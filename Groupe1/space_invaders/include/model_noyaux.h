@@ -0,0 +1,105 @@
+/*
+ * Noyaux de calcul du modèle, appliqués aux tableaux en colonnes
+ * (structure de tableaux) de `model.c`.
+ *
+ * Les coordonnées sont en `int16_t` et les masques de vie en `uint8_t`
+ * (0x00 = mort, 0xFF = vivant) pour que SSE2 traite 8 à 16 entités par
+ * instruction et AVX2 16. La variante est choisie à la compilation :
+ * AVX2 si `__AVX2__`, sinon SSE2 si `__SSE2__`, sinon code scalaire.
+ * `-DMODEL_SCALAIRE` force la version scalaire (comparaisons de mesure).
+ *
+ * Module interne : seul `model.c` (et le banc de mesure) l'utilise.
+ */
+#ifndef MODEL_NOYAUX_H
+#define MODEL_NOYAUX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MASQUE_VIVANT 0xFF
+
+/* Nom de la variante compilée : "avx2", "sse2" ou "scalaire". */
+const char* noyau_variante(void);
+
+/* Particules vivantes (ttl > 0) : x += vx, y += vy, ttl -= 1. */
+void noyau_avancer_particules(int16_t* x, int16_t* y, const int16_t* vx, const int16_t* vy,
+                              int16_t* ttl, int n);
+
+/* Projectiles actifs : y += dy, puis désactive ceux qui sortent de [0, hauteur). */
+void noyau_avancer_projectiles(int16_t* y, const int16_t* dy, uint8_t* actif, int n, int hauteur);
+
+/* @return 1 si un octet de v[0..n) sort de [min, max], 0 sinon. */
+int noyau_octets_hors(const uint8_t* v, int n, uint8_t min, uint8_t max);
+
+/*
+ * Grille d'occupation (bitboard) : un bit par case du terrain, `mots_par_ligne`
+ * mots de 64 bits par ligne. Le bit x de la ligne y est le bit (x & 63) du
+ * mot (x >> 6) de la ligne. Tester une case coûte un ET logique, quel que
+ * soit le nombre d'entités posées. Le stockage appartient à l'appelant.
+ */
+typedef struct {
+    uint64_t* mots;
+    int mots_par_ligne;
+    int largeur;
+    int hauteur;
+} Grille;
+
+/* Nombre de mots de 64 bits nécessaires pour une grille largeur x hauteur. */
+static inline size_t grille_nombre_mots(int largeur, int hauteur) {
+    return (size_t)((largeur + 63) / 64) * (size_t)hauteur;
+}
+
+/* Associe `stockage` (grille_nombre_mots mots) à la grille et la vide. */
+void grille_lier(Grille* g, uint64_t* stockage, int largeur, int hauteur);
+
+/* Efface toutes les cases. */
+void grille_vider(Grille* g);
+
+static inline int grille_dans(const Grille* g, int x, int y) {
+    return x >= 0 && x < g->largeur && y >= 0 && y < g->hauteur;
+}
+
+static inline uint64_t* grille_mot(const Grille* g, int x, int y) {
+    return &g->mots[(size_t)y * (size_t)g->mots_par_ligne + (size_t)(x >> 6)];
+}
+
+static inline void grille_poser(Grille* g, int x, int y) {
+    if (grille_dans(g, x, y)) *grille_mot(g, x, y) |= (uint64_t)1 << (x & 63);
+}
+
+static inline void grille_effacer(Grille* g, int x, int y) {
+    if (grille_dans(g, x, y)) *grille_mot(g, x, y) &= ~((uint64_t)1 << (x & 63));
+}
+
+static inline int grille_occupee(const Grille* g, int x, int y) {
+    return grille_dans(g, x, y) && ((*grille_mot(g, x, y) >> (x & 63)) & 1u);
+}
+
+/* Efface les lignes [y_min, y_max] (bornées à la grille). */
+void grille_vider_lignes(Grille* g, int y_min, int y_max);
+
+/* Masques de bits (un bit par emplacement de la formation) */
+
+/* Nombre de bits à 1 de `v`. */
+static inline int mot_compter(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    int c = 0;
+    while (v) { v &= v - 1; ++c; }
+    return c;
+#endif
+}
+
+/* Position du bit à 1 de plus faible poids (`v` non nul). */
+static inline int mot_premier_bit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#else
+    int i = 0;
+    while (!(v & 1u)) { v >>= 1; ++i; }
+    return i;
+#endif
+}
+
+#endif /* MODEL_NOYAUX_H */
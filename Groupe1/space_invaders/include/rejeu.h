@@ -0,0 +1,70 @@
+/*
+ * Enregistrement et rejeu des parties : chaque commande qui atteint le
+ * contrôleur est écrite avec son tick dans un fichier binaire compact, que
+ * `--replay=FICHIER` rejoue ensuite à travers le contrôleur, sans limite de
+ * vitesse, pour reproduire une partie et mesurer ses ticks lents.
+ *
+ * Format : un `EnteteRejeu`, puis une suite d'enregistrements. Chacun
+ * commence par un varint (LEB128) valant `(delta << 3) | code` :
+ *   code 0..5 : une `Commande`, appliquée au début du tick `tick`
+ *   code 6    : fin de l'enregistrement, au dernier tick joué
+ *   code 7    : image clé, suivie d'un varint (taille) et du blob de
+ *               `etatjeu_sauver` pris au début du tick `tick`
+ * `delta` est le nombre de ticks depuis l'enregistrement précédent. Le
+ * tick du modèle repart de 0 après CMD_RECOMMENCER, le delta aussi. Le
+ * premier enregistrement est toujours une image clé (état de départ) ;
+ * les suivantes permettent de commencer le rejeu au milieu d'une longue
+ * partie sans la resimuler depuis le tick 0.
+ */
+#ifndef REJEU_H
+#define REJEU_H
+
+#include <stdint.h>
+#include "model.h"
+#include "controller.h"
+
+#define REJEU_MAGIC 0x50524953u /* "SIRP" */
+#define REJEU_VERSION 1
+/* Ticks au moins entre deux images clés (10 s de jeu) */
+#define REJEU_INTERVALLE_DEFAUT 600
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t taille_entete;
+    uint64_t graine;        /* graine de la partie enregistrée */
+    uint32_t intervalle;    /* ticks entre deux images clés */
+    uint32_t reserve;
+} EnteteRejeu;
+
+typedef struct Enregistreur Enregistreur;
+
+/* Crée `chemin` et y écrit l'en-tête et l'image clé de départ de `e`.
+ * Une image clé est ajoutée à la première commande reçue au moins
+ * `intervalle` ticks après la précédente (<= 0 : REJEU_INTERVALLE_DEFAUT).
+ * @return NULL en cas d'erreur.
+ */
+Enregistreur* rejeu_enregistrer_ouvrir(const char* chemin, const EtatJeu* e, int intervalle);
+
+/* Écrit la commande `c`, reçue au tick courant de `e` (appelé par le contrôleur). */
+void rejeu_enregistrer_commande(Enregistreur* r, const EtatJeu* e, Commande c);
+
+/* Écrit l'enregistrement de fin au tick courant de `e` et ferme le fichier.
+ * @return 0 si tout le fichier a été écrit, 1 sinon.
+ */
+int rejeu_enregistrer_fermer(Enregistreur* r, const EtatJeu* e);
+
+typedef struct {
+    const char* chemin;
+    long tick_depart;   /* tick de session où commencer (0 = début) ; le rejeu part de l'image clé précédente */
+    long ticks_max;     /* arrêt après N ticks rejoués (0 = tout le fichier) */
+} ConfigRejeu;
+
+/* Rejoue le fichier et imprime le rapport (ticks/s, latence par tick, tick
+ * le plus lent, images clés vérifiées) sur la sortie standard.
+ * @return 0 si succès, 1 si le fichier est invalide ou si la partie rejouée
+ *         s'écarte d'une image clé.
+ */
+int rejeu_executer(const ConfigRejeu* c);
+
+#endif /* REJEU_H */
@@ -0,0 +1,37 @@
+/*
+ * Fichiers de sauvegarde : le blob de `etatjeu_sauver` écrit tel quel sur
+ * disque, relu par projection en mémoire (mmap) pour reprendre une partie
+ * sans copie intermédiaire.
+ */
+#ifndef SAUVEGARDE_H
+#define SAUVEGARDE_H
+
+#include <stddef.h>
+#include "model.h"
+
+/* Fichier projeté en lecture seule */
+typedef struct {
+    const void* donnees;
+    size_t taille;
+    int projete;  /* 1 : mmap, 0 : copie lue par fread (Windows, ou mmap refusé) */
+} FichierSauvegarde;
+
+/* Écrit la sauvegarde de `e` dans `chemin` (remplacé s'il existe).
+ * @return 0 si succès, 1 en cas d'erreur.
+ */
+int sauvegarde_ecrire(const EtatJeu* e, const char* chemin);
+
+/* Projette `chemin` en mémoire.
+ * @return 0 si succès, 1 si le fichier est illisible.
+ */
+int sauvegarde_ouvrir(FichierSauvegarde* f, const char* chemin);
+
+/* Libère la projection ouverte par `sauvegarde_ouvrir`. */
+void sauvegarde_fermer(FichierSauvegarde* f);
+
+/* Crée une partie depuis le fichier `chemin`.
+ * @return NULL si le fichier est illisible ou n'est pas une sauvegarde valide.
+ */
+EtatJeu* sauvegarde_charger(const char* chemin);
+
+#endif /* SAUVEGARDE_H */
@@ -0,0 +1,60 @@
+/*
+ * Outils de simulation sans interface : politiques d'entrée automatiques,
+ * horloge monotone et histogramme de latence. Utilisés par la vue headless
+ * pour mesurer le débit du modèle.
+ */
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "model.h"
+
+/* Politique d'entrée : décide des commandes envoyées au contrôleur à chaque tick */
+typedef enum {
+    POLITIQUE_ALEATOIRE, /* gauche / droite / tir tirés au hasard */
+    POLITIQUE_SCRIPT,    /* script rejoué en boucle, un caractère par tick */
+    POLITIQUE_INACTIVE   /* aucune commande */
+} TypePolitique;
+
+/* Script par défaut : 'g' gauche, 'd' droite, 't' tirer, '.' rien */
+#define SCRIPT_DEFAUT "dddt.dddt.gggt.gggt."
+
+typedef struct {
+    TypePolitique type;
+    const char* script;
+    size_t position;
+    uint32_t alea; /* générateur propre à la politique (xorshift32) */
+} PolitiqueEntree;
+
+/* Initialise une politique. `script` peut être NULL (SCRIPT_DEFAUT). */
+void politique_initialiser(PolitiqueEntree* p, TypePolitique type, const char* script, unsigned int graine);
+
+/* Envoie au contrôleur les commandes d'un tick. */
+void politique_appliquer(PolitiqueEntree* p, EtatJeu* e);
+
+/* Convertit "random" / "script" / "idle" ; retourne -1 si inconnu. */
+int politique_depuis_nom(const char* nom);
+
+/* Horloge monotone en nanosecondes. */
+uint64_t horloge_ns(void);
+
+/* Histogramme log-linéaire : 16 sous-seaux par puissance de deux,
+ * précision relative ~6 %, taille fixe et sans allocation. */
+#define HISTO_SOUS_SEAUX 16
+#define HISTO_NB_SEAUX (64 * HISTO_SOUS_SEAUX)
+
+typedef struct {
+    uint64_t seaux[HISTO_NB_SEAUX];
+    uint64_t nombre;
+    uint64_t min;
+    uint64_t max;
+    double somme;
+} HistogrammeLatence;
+
+void histo_initialiser(HistogrammeLatence* h);
+void histo_ajouter(HistogrammeLatence* h, uint64_t valeur);
+/* Retourne la borne basse du seau contenant le quantile q (0..1). */
+uint64_t histo_percentile(const HistogrammeLatence* h, double q);
+
+#endif /* SIMULATION_H */
@@ -12,4 +12,36 @@ void bitmap_draw_text(SDL_Renderer* renderer, int x, int y, const char* text, SD
 /* Variante avec taille et espacement personnalisés */
 void bitmap_draw_text_custom(SDL_Renderer* renderer, int x, int y, const char* text, SDL_Color color, int pixel_size, int spacing);
 
+/*
+ * La police est rastérisée une fois par taille de pixel dans une texture
+ * atlas propre au renderer ; une chaîne est ensuite un quad texturé par
+ * caractère, soumis en un seul `SDL_RenderGeometry`, et la couleur vient de
+ * la modulation de la texture. Si l'atlas ne peut pas être créé, les
+ * glyphes sont dessinés rectangle par rectangle comme avant.
+ */
+#define BITMAP_ATLAS_MAX 8 /* atlas gardés (couples renderer, taille) */
+
+/*
+ * Au-dessus de l'atlas, chaque chaîne dessinée garde sa propre texture
+ * (clé : renderer, texte, taille, espacement ; la couleur est appliquée par
+ * modulation). Tant qu'un libellé ne change pas, le redessiner coûte un
+ * seul `SDL_RenderTexture`, sans rastérisation. Les chaînes plus longues
+ * que `BITMAP_LIBELLE_LONGUEUR_MAX` passent par l'atlas.
+ */
+#define BITMAP_LIBELLES_MAX 48          /* libellés gardés, remplacement LRU */
+#define BITMAP_LIBELLE_LONGUEUR_MAX 63
+
+typedef struct {
+    unsigned long rasterisations; /* libellés rastérisés (défauts de cache) */
+    unsigned long retrouves;      /* libellés redessinés depuis leur texture */
+    unsigned long evinces;        /* libellés remplacés faute de place */
+} BitmapTextStats;
+
+/* Compteurs cumulés du cache de libellés, depuis le lancement. */
+void bitmap_text_stats(BitmapTextStats* out);
+
+/* Détruit les atlas et les libellés créés pour `renderer` : à appeler avant
+ * `SDL_DestroyRenderer`. */
+void bitmap_font_release(SDL_Renderer* renderer);
+
 #endif /* TEXT_BITMAP_H */
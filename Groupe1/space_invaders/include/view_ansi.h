@@ -0,0 +1,25 @@
+/*
+ * Vue ANSI : rendu texte sans ncurses, pour les conteneurs minimaux et les
+ * sessions distantes. Le terminal est passé en mode brut (termios) et chaque
+ * image est construite dans un tampon alloué une fois, sous forme de
+ * séquences d'échappement minimales : le curseur ne saute qu'aux cases
+ * modifiées, la couleur n'est changée que quand elle diffère. L'image part
+ * au terminal en un seul `write()`.
+ *
+ * Pas de menus ni de high-scores : `--view=ansi` lance directement une
+ * partie. Touches : 'a'/'gauche', 'd'/'droite', 'espace' tirer, 'p' pause,
+ * 'q' quitter ; après un game over, 'r' recommence.
+ */
+#ifndef VIEW_ANSI_H
+#define VIEW_ANSI_H
+
+#include "model.h"
+
+/* Démarre la boucle de la vue ANSI sur l'entrée et la sortie standard.
+ * À la fin, imprime sur la sortie d'erreur le nombre d'images, les octets
+ * écrits par image et le temps moyen de construction d'une image.
+ * @return 0 si succès, >0 si la sortie n'est pas un terminal ou en cas d'erreur.
+ */
+int vue_ansi_executer(EtatJeu* e);
+
+#endif /* VIEW_ANSI_H */
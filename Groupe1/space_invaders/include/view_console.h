@@ -9,7 +9,9 @@
 #define VIEW_CONSOLE_H
 
 #include "model.h"
+#ifdef HAVE_NCURSES
 #include <ncursesw/curses.h>
+#endif
 
 typedef struct {
 	int gauche;
@@ -22,10 +24,55 @@ typedef struct {
 void vue_console_get_bindings(ConsoleKeyBindings* out);
 void vue_console_set_bindings(const ConsoleKeyBindings* in);
 
-/* Démarre la boucle de la vue console.
+/* Paires de couleurs de la session console, définies une fois à
+ * l'ouverture et partagées par les menus et le jeu */
+#define PAIRE_ENNEMI 1
+#define PAIRE_VAISSEAU 2
+#define PAIRE_TIR 3
+#define PAIRE_TIR_ENNEMI 4
+#define PAIRE_TEXTE 5
+#define PAIRE_BOUCLIER 6
+#define PAIRE_PARTICULE 7
+#define PAIRE_TITRE 8
+#define PAIRE_SELECTION 9
+#define PAIRE_NOMBRE 10
+
+/* Écrans de la session : chacun dessine dans sa propre fenêtre ncurses */
+#define ECRAN_MENU 0
+#define ECRAN_JEU 1
+
+/*
+ * Session console : le terminal est initialisé une fois par
+ * `vue_console_ouvrir` (initscr, modes, paires de couleurs) et rendu par
+ * `vue_console_fermer`. Menus et parties dessinent dans leur fenêtre
+ * (`vue_console_ecran`) puis publient par `wnoutrefresh` + `doupdate` :
+ * changer d'écran n'envoie au terminal que les cases qui diffèrent.
+ */
+typedef struct ContexteConsole ContexteConsole;
+
+/* @return la session, ou NULL si le terminal ne peut pas être initialisé (ou ncurses est absent). */
+ContexteConsole* vue_console_ouvrir(void);
+
+/* Détruit les fenêtres, rend le terminal, puis recopie sur la sortie
+ * d'erreur les rapports écrits pendant la session. */
+void vue_console_fermer(ContexteConsole* c);
+
+#ifdef HAVE_NCURSES
+/* Début d'un écran : la fenêtre de l'écran, à redessiner en entier
+ * (`werase` puis dessin) avant le prochain `vue_console_publier`. */
+WINDOW* vue_console_ecran(ContexteConsole* c, int ecran);
+
+/* Attribut d'une paire PAIRE_* (A_NORMAL si le terminal n'a pas de couleurs) */
+attr_t vue_console_couleur(const ContexteConsole* c, int paire);
+
+/* `wnoutrefresh` de la fenêtre puis `doupdate` */
+void vue_console_publier(ContexteConsole* c, WINDOW* fenetre);
+#endif /* HAVE_NCURSES */
+
+/* Lance une partie dans la session `c`.
  * @param e : pointeur vers l'état du jeu (modèle)
  * @return 0 si succès, >0 en cas d'erreur.
  */
-int vue_console_executer(EtatJeu* e);
+int vue_console_executer(ContexteConsole* c, EtatJeu* e);
 
 #endif /* VIEW_CONSOLE_H */
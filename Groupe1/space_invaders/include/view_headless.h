@@ -0,0 +1,52 @@
+/*
+ * Vue headless : fait tourner le modèle sans terminal ni fenêtre,
+ * avec une politique d'entrée automatique, puis affiche un rapport
+ * de débit (ticks/s, parties/s) et la distribution de latence par tick.
+ */
+#ifndef VIEW_HEADLESS_H
+#define VIEW_HEADLESS_H
+
+#include "model.h"
+#include "simulation.h"
+
+typedef struct {
+    long ticks_max;          /* arrêt après N ticks (0 = sans limite) */
+    long parties_max;        /* arrêt après N parties terminées (0 = sans limite) */
+    TypePolitique politique;
+    const char* script;      /* utilisé par POLITIQUE_SCRIPT */
+    unsigned int graine;     /* graine du modèle et de la politique d'entrée */
+    ConfigJeu jeu;           /* terrain, vague et capacités de la partie */
+    const char* enregistrement; /* fichier de rejeu à écrire (NULL = aucun) */
+    int intervalle_images;   /* ticks entre deux images clés du rejeu */
+} ConfigHeadless;
+
+/* Remplit `c` avec les valeurs par défaut (100000 ticks, politique aléatoire) ; chaque tick dure PAS_FIXE. */
+void vue_headless_config_defaut(ConfigHeadless* c);
+
+/* Lance la simulation et imprime le rapport sur la sortie standard.
+ * @return 0 si succès, >0 en cas d'erreur.
+ */
+int vue_headless_executer(const ConfigHeadless* c);
+
+/* Mode `--kernels=N` : mesure chaque noyau de `model_noyaux.h` sur N entités
+ * (`iterations` appels par noyau) et imprime le coût par appel et par entité.
+ * @return 0 si succès, >0 en cas d'erreur.
+ */
+int vue_headless_noyaux(int n, long iterations);
+
+/* Mode `--collisions=N` : N ennemis et N tirs sur un terrain de 128 x 64 cases
+ * au départ, agrandi pour loger N ennemis ; compare la détection par
+ * boucles imbriquées et par grille d'occupation (`iterations` passes).
+ * @return 0 si succès et résultats identiques, >0 sinon.
+ */
+int vue_headless_collisions(int n, long iterations);
+
+/* Mode `--snapshots` : joue 600 ticks selon `c`, puis compare le coût de
+ * `etatjeu_reinitialiser`, `etatjeu_sauver` et `etatjeu_restaurer`
+ * (`iterations` appels chacun) et vérifie que la partie restaurée évolue
+ * comme l'originale.
+ * @return 0 si succès, >0 sinon.
+ */
+int vue_headless_sauvegarde(const ConfigHeadless* c, long iterations);
+
+#endif /* VIEW_HEADLESS_H */
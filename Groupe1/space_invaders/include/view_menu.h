@@ -16,22 +16,26 @@
 #define MENU_RETOUR 4
 #define MENU_OPTIONS 5
 
+/* Menus console, dans la session ouverte par `vue_console_ouvrir` (voir view_console.h) */
+struct ContexteConsole;
+
 /* Affiche le menu principal et retourne le choix de l'utilisateur */
-int vue_console_menu_principal(void);
+int vue_console_menu_principal(struct ContexteConsole* c);
 
 /* Affiche les meilleurs scores */
-void vue_console_afficher_highscores(HighScoreList* list);
+void vue_console_afficher_highscores(struct ContexteConsole* c, HighScoreList* list);
 
 /* Affiche le menu options (console) */
-void vue_console_menu_options(void);
+void vue_console_menu_options(struct ContexteConsole* c);
 
 /* Demande le nom du joueur et retourne le nom saisi */
-char* vue_console_saisir_nom(int score, HighScoreList* list);
-
-/* Versions SDL */
-int vue_sdl_menu_principal(void);
-void vue_sdl_afficher_highscores(HighScoreList* list);
-char* vue_sdl_saisir_nom(int score, HighScoreList* list);
-void vue_sdl_menu_options(void);
+char* vue_console_saisir_nom(struct ContexteConsole* c, int score, HighScoreList* list);
+
+/* Versions SDL, dans le contexte ouvert par `vue_sdl_ouvrir` (voir view_sdl.h) */
+struct ContexteSDL;
+int vue_sdl_menu_principal(struct ContexteSDL* c);
+void vue_sdl_afficher_highscores(struct ContexteSDL* c, HighScoreList* list);
+char* vue_sdl_saisir_nom(struct ContexteSDL* c, int score, HighScoreList* list);
+void vue_sdl_menu_options(struct ContexteSDL* c);
 
 #endif /* VIEW_MENU_H */
@@ -1,15 +1,14 @@
 /*
- * Interface pour une future vue SDL. Le fichier `src/view_sdl.c`
- * fourni dans ce dépôt est minimal (sans inclusion de SDL)
- * pour permettre la compilation sur des systèmes sans SDL3.
- *
- * Pour activer une vraie vue graphique : remplacer `src/view_sdl.c`
- * par une implémentation qui inclut <SDL3/SDL.h> et réalise le rendu.
+ * Interface de la vue SDL3 (`src/view_sdl.c`). Sans SDL3, le Makefile
+ * compile `src/view_sdl_stub.c` à la place : `vue_sdl_ouvrir` y signale
+ * l'absence de SDL3 et retourne NULL.
  */
 #ifndef VIEW_SDL_H
 #define VIEW_SDL_H
 
 #include "model.h"
+
+#ifdef HAVE_SDL3
 #include <SDL3/SDL.h>
 
 typedef struct {
@@ -22,8 +21,50 @@ typedef struct {
 
 void vue_sdl_get_bindings(KeyBindings* out);
 void vue_sdl_set_bindings(const KeyBindings* in);
+#endif /* HAVE_SDL3 */
+
+/*
+ * Contexte SDL partagé : SDL, la fenêtre, le renderer et les textures du
+ * texte (atlas, libellés) sont créés une fois par `vue_sdl_ouvrir`, puis
+ * passés à chaque écran (menus, partie, saisie du nom). Passer d'un écran
+ * à l'autre ne recrée rien : la fenêtre reste ouverte et les textures
+ * restent valides. Chaque écran mesure le temps jusqu'à sa première image ;
+ * `vue_sdl_fermer` en imprime le résumé sur la sortie d'erreur.
+ */
+typedef struct ContexteSDL ContexteSDL;
+
+/* @return le contexte, ou NULL si SDL ne peut pas être initialisé (ou est absent). */
+ContexteSDL* vue_sdl_ouvrir(void);
+
+/* Détruit textures, renderer et fenêtre, puis quitte SDL. */
+void vue_sdl_fermer(ContexteSDL* c);
+
+#ifdef HAVE_SDL3
+/* Pour les écrans SDL : renderer et fenêtre du contexte */
+SDL_Renderer* vue_sdl_rendu(ContexteSDL* c);
+SDL_Window* vue_sdl_fenetre(ContexteSDL* c);
+
+/* Début d'un écran : titre de la fenêtre et taille logique du dessin
+ * (0 x 0 : pixels de la fenêtre) ; vide les événements de l'écran précédent. */
+void vue_sdl_ecran(ContexteSDL* c, const char* titre, int largeur_logique, int hauteur_logique);
+
+/* `SDL_RenderPresent`, et mesure de la transition à la première image de l'écran */
+void vue_sdl_presenter(ContexteSDL* c);
+#endif /* HAVE_SDL3 */
+
+/* Rendu du terrain pendant une partie :
+ * - RENDU_SDL_RECTANGLES : rectangles par lots, entités interpolées entre deux ticks ;
+ * - RENDU_SDL_TEXTURE : le calque du modèle rastérisé sur le CPU,
+ *   `pixels_case` x `pixels_case` pixels par case, dans une texture
+ *   streaming étirée sur la fenêtre en un seul `SDL_RenderTexture`. */
+#define RENDU_SDL_RECTANGLES 0
+#define RENDU_SDL_TEXTURE 1
+#define PIXELS_CASE_MAX 16
+
+/* Choisit le rendu des parties suivantes (RENDU_SDL_RECTANGLES par défaut) */
+void vue_sdl_definir_rendu(ContexteSDL* c, int mode, int pixels_case);
 
-/* Lance la vue SDL (stub par défaut). Retourne 0 si OK, sinon >0. */
-int vue_sdl_executer(EtatJeu* e);
+/* Lance une partie dans le contexte `c`. Retourne 0 si OK, sinon >0. */
+int vue_sdl_executer(ContexteSDL* c, EtatJeu* e);
 
 #endif /* VIEW_SDL_H */
@@ -0,0 +1,249 @@
+/*
+ * batch.c
+ * -------
+ * Pool de threads qui répartit des parties indépendantes sur les cœurs.
+ *
+ * Chaque thread possède une file de parties (un intervalle d'indices
+ * [debut, fin) protégé par un mutex). Le propriétaire prend ses parties
+ * par la fin ; un thread dont la file est vide vole la partie au début
+ * de la file d'un autre. Une partie longue n'immobilise donc que le
+ * thread qui la joue : les parties restantes de sa file sont reprises
+ * par les threads inoccupés.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+#include "model.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct {
+    pthread_mutex_t verrou;
+    long debut;
+    long fin;
+} FileParties;
+
+typedef struct PoolBatch PoolBatch;
+
+typedef struct {
+    PoolBatch* pool;
+    int id;
+    pthread_t thread;
+    ResultatBatch local; /* cumuls propres au thread, fusionnés après join */
+} Ouvrier;
+
+struct PoolBatch {
+    const ConfigBatch* config;
+    FileParties* files;
+    Ouvrier* ouvriers;
+    int nb;
+};
+
+void batch_config_defaut(ConfigBatch* c) {
+    if (!c) return;
+    c->nb_threads = 0;
+    c->nb_parties = 1000;
+    c->ticks_max_partie = 0;
+    c->politique = POLITIQUE_ALEATOIRE;
+    c->script = NULL;
+    c->graine = 1;
+    etatjeu_config_defaut(&c->jeu);
+}
+
+int batch_nombre_coeurs(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/* Le propriétaire prend la dernière partie de sa file */
+static int prendre_locale(FileParties* f, long* partie) {
+    int ok = 0;
+    pthread_mutex_lock(&f->verrou);
+    if (f->debut < f->fin) {
+        *partie = --f->fin;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&f->verrou);
+    return ok;
+}
+
+/* Un voleur prend la première partie de la file d'un autre thread */
+static int voler(FileParties* f, long* partie) {
+    int ok = 0;
+    pthread_mutex_lock(&f->verrou);
+    if (f->debut < f->fin) {
+        *partie = f->debut++;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&f->verrou);
+    return ok;
+}
+
+static void jouer_partie(const ConfigBatch* c, long indice, ResultatBatch* local) {
+    /* même graine pour le modèle et la politique : chaque partie est reproductible seule */
+    unsigned int graine = c->graine + (unsigned int)indice;
+    EtatJeu* e = etatjeu_creer_config(&c->jeu, graine);
+    if (!e) {
+        local->echecs++;
+        return;
+    }
+
+    PolitiqueEntree politique;
+    politique_initialiser(&politique, c->politique, c->script, graine);
+
+    long ticks = 0;
+    while (!etatjeu_est_game_over(e) && !etatjeu_devrait_quitter(e)) {
+        if (c->ticks_max_partie > 0 && ticks >= c->ticks_max_partie) break;
+        politique_appliquer(&politique, e);
+        etatjeu_tick(e);
+        ++ticks;
+    }
+
+    local->parties++;
+    local->ticks += ticks;
+    local->score_total += etatjeu_obtenir_score(e);
+    etatjeu_detruire(e);
+}
+
+static void* boucle_ouvrier(void* arg) {
+    Ouvrier* o = (Ouvrier*)arg;
+    PoolBatch* pool = o->pool;
+    long partie;
+
+    for (;;) {
+        if (prendre_locale(&pool->files[o->id], &partie)) {
+            jouer_partie(pool->config, partie, &o->local);
+            continue;
+        }
+        /* file vide : tenter un vol, en partant du voisin */
+        int vole = 0;
+        for (int k = 1; k < pool->nb && !vole; ++k) {
+            int victime = (o->id + k) % pool->nb;
+            if (voler(&pool->files[victime], &partie)) vole = 1;
+        }
+        if (!vole) break; /* aucune file ne contient plus de travail : le lot est fini */
+        o->local.vols++;
+        jouer_partie(pool->config, partie, &o->local);
+    }
+    return NULL;
+}
+
+int batch_executer(const ConfigBatch* c, ResultatBatch* out) {
+    if (!c || !out || c->nb_parties <= 0) return 1;
+    memset(out, 0, sizeof(*out));
+
+    int nb = c->nb_threads > 0 ? c->nb_threads : batch_nombre_coeurs();
+    if (nb > c->nb_parties) nb = (int)c->nb_parties;
+
+    PoolBatch pool;
+    pool.config = c;
+    pool.nb = nb;
+    pool.files = (FileParties*)calloc((size_t)nb, sizeof(FileParties));
+    pool.ouvriers = (Ouvrier*)calloc((size_t)nb, sizeof(Ouvrier));
+    if (!pool.files || !pool.ouvriers) {
+        free(pool.files);
+        free(pool.ouvriers);
+        return 1;
+    }
+
+    /* répartition initiale : des tranches contiguës de même taille */
+    for (int i = 0; i < nb; ++i) {
+        pthread_mutex_init(&pool.files[i].verrou, NULL);
+        pool.files[i].debut = c->nb_parties * i / nb;
+        pool.files[i].fin = c->nb_parties * (i + 1) / nb;
+        pool.ouvriers[i].pool = &pool;
+        pool.ouvriers[i].id = i;
+    }
+
+    int rc = 0;
+    int lances = 0;
+    uint64_t debut = horloge_ns();
+    for (; lances < nb; ++lances) {
+        if (pthread_create(&pool.ouvriers[lances].thread, NULL, boucle_ouvrier, &pool.ouvriers[lances]) != 0) {
+            fprintf(stderr, "Échec de création du thread %d\n", lances);
+            rc = 1;
+            break;
+        }
+    }
+    /* même en cas d'échec, les threads lancés volent tout le travail restant */
+    for (int i = 0; i < lances; ++i) pthread_join(pool.ouvriers[i].thread, NULL);
+    out->duree_ns = horloge_ns() - debut;
+
+    for (int i = 0; i < nb; ++i) {
+        out->parties += pool.ouvriers[i].local.parties;
+        out->ticks += pool.ouvriers[i].local.ticks;
+        out->score_total += pool.ouvriers[i].local.score_total;
+        out->vols += pool.ouvriers[i].local.vols;
+        out->echecs += pool.ouvriers[i].local.echecs;
+        pthread_mutex_destroy(&pool.files[i].verrou);
+    }
+
+    free(pool.files);
+    free(pool.ouvriers);
+    if (lances == 0) rc = 1;
+    if (out->echecs > 0) {
+        fprintf(stderr, "Échec de création de %ld partie(s) sur %ld\n", out->echecs, c->nb_parties);
+        rc = 1;
+    }
+    return rc;
+}
+
+static double ticks_par_seconde(const ResultatBatch* r) {
+    double s = (double)r->duree_ns / 1e9;
+    return s > 0.0 ? (double)r->ticks / s : 0.0;
+}
+
+int vue_batch_executer(const ConfigBatch* c, int echelle) {
+    if (!c) return 1;
+    int max_threads = c->nb_threads > 0 ? c->nb_threads : batch_nombre_coeurs();
+
+    printf("=== Simulation par lots ===\n");
+    printf("parties : %ld  coeurs detectes : %d\n", c->nb_parties, batch_nombre_coeurs());
+    printf("%8s %14s %10s %10s %10s %8s\n", "threads", "ticks/s", "parties/s", "accel.", "efficacite", "vols");
+
+    double reference = 0.0;
+    int t = echelle ? 1 : max_threads;
+    const int t_reference = t;
+    for (;;) {
+        ConfigBatch essai = *c;
+        essai.nb_threads = t;
+        ResultatBatch r;
+        if (batch_executer(&essai, &r) != 0) {
+            fprintf(stderr, "Échec du lot avec %d threads\n", t);
+            return 1;
+        }
+        double tps = ticks_par_seconde(&r);
+        if (reference <= 0.0) reference = tps;
+        double accel = reference > 0.0 ? tps / reference : 0.0;
+        double secondes = (double)r.duree_ns / 1e9;
+        printf("%8d %14.0f %10.1f %9.2fx %9.0f%% %8ld\n", t, tps,
+               secondes > 0.0 ? (double)r.parties / secondes : 0.0,
+               accel, 100.0 * accel * t_reference / t, r.vols);
+
+        if (t >= max_threads) {
+            printf("score moyen : %.1f  ticks/partie : %.0f\n",
+                   r.parties ? (double)r.score_total / (double)r.parties : 0.0,
+                   r.parties ? (double)r.ticks / (double)r.parties : 0.0);
+            break;
+        }
+        t *= 2;
+        if (t > max_threads) t = max_threads;
+    }
+    return 0;
+}
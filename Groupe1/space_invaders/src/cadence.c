@@ -0,0 +1,108 @@
+/*
+ * cadence.c
+ * ---------
+ * Attente à échéance absolue pour les vues interactives (voir cadence.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cadence.h"
+
+#include <errno.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+void cadence_demarrer(Cadence* c, int images_par_seconde) {
+    if (!c) return;
+    if (images_par_seconde < 1) images_par_seconde = 1;
+    c->periode = 1000000000ull / (uint64_t)images_par_seconde;
+    c->echeance = horloge_ns() + c->periode;
+    c->marge = 200000; /* 200 µs, ajustée dès les premiers réveils */
+    c->retard_reveil = 100000;
+    histo_initialiser(&c->ecart);
+    c->images = 0;
+    c->en_retard = 0;
+    c->sautees = 0;
+}
+
+/* Dort jusqu'à l'instant `cible` de horloge_ns (CLOCK_MONOTONIC) */
+static void dormir_jusqua(uint64_t cible) {
+#ifdef _WIN32
+    uint64_t maintenant = horloge_ns();
+    if (cible > maintenant) Sleep((DWORD)((cible - maintenant) / 1000000ull));
+#elif defined(__APPLE__)
+    /* pas de clock_nanosleep : sommeil relatif, recalculé depuis l'échéance
+     * après chaque interruption par un signal */
+    for (;;) {
+        uint64_t maintenant = horloge_ns();
+        if (cible <= maintenant) return;
+        uint64_t reste = cible - maintenant;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(reste / 1000000000ull);
+        ts.tv_nsec = (long)(reste % 1000000000ull);
+        if (nanosleep(&ts, NULL) == 0 || errno != EINTR) return;
+    }
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(cible / 1000000000ull);
+    ts.tv_nsec = (long)(cible % 1000000000ull);
+    /* interrompu par un signal : l'échéance absolue ne bouge pas, on
+     * recommence ; toute autre erreur laisse la boucle active finir */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+#endif
+}
+
+uint64_t cadence_attendre(Cadence* c) {
+    if (!c) return 0;
+    uint64_t debut = horloge_ns();
+    c->images += 1;
+    if (debut >= c->echeance) {
+        c->en_retard += 1;
+        histo_ajouter(&c->ecart, debut - c->echeance);
+        if (debut - c->echeance >= c->periode) {
+            c->sautees += (long)((debut - c->echeance) / c->periode);
+            c->echeance = debut + c->periode;
+        } else {
+            c->echeance += c->periode;
+        }
+        return 0;
+    }
+
+    if (c->echeance - debut > c->marge) {
+        uint64_t reveil_vise = c->echeance - c->marge;
+        dormir_jusqua(reveil_vise);
+        uint64_t reveil = horloge_ns();
+        uint64_t retard = reveil > reveil_vise ? reveil - reveil_vise : 0;
+        /* moyenne glissante (1/8) ; la marge couvre deux fois le retard moyen */
+        c->retard_reveil = c->retard_reveil - c->retard_reveil / 8 + retard / 8;
+        c->marge = 2 * c->retard_reveil;
+        if (c->marge < CADENCE_MARGE_MIN) c->marge = CADENCE_MARGE_MIN;
+        if (c->marge > CADENCE_MARGE_MAX) c->marge = CADENCE_MARGE_MAX;
+    }
+    uint64_t fin;
+    while ((fin = horloge_ns()) < c->echeance) {
+        /* boucle active : les derniers microsecondes */
+    }
+    histo_ajouter(&c->ecart, fin - c->echeance);
+    c->echeance += c->periode;
+    return fin - debut;
+}
+
+void cadence_recaler(Cadence* c) {
+    if (!c) return;
+    c->echeance = horloge_ns() + c->periode;
+}
+
+void cadence_rapport(const Cadence* c, const char* nom, FILE* f) {
+    if (!c || !f || c->images == 0) return;
+    fprintf(f, "%s : %ld images a %.0f ips, ecart a l'echeance p50 %.1f us, p99 %.1f us, max %.1f us ; "
+               "%ld en retard, %ld echeances sautees\n",
+            nom, c->images, 1e9 / (double)c->periode,
+            (double)histo_percentile(&c->ecart, 0.50) / 1e3,
+            (double)histo_percentile(&c->ecart, 0.99) / 1e3,
+            (double)c->ecart.max / 1e3, c->en_retard, c->sautees);
+}
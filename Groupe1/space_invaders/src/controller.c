@@ -1,4 +1,5 @@
 #include "controller.h"
+#include "rejeu.h"
 #include <stdio.h>
 
 /*
@@ -10,9 +11,19 @@
 /* Accès à une aide interne du module modèle pour définir le flag "quitter" */
 extern void _etatjeu_definir_quitter(EtatJeu* e, int q);
 
+/* Enregistrement en cours : fixé avant la partie, lu seulement pendant */
+static Enregistreur* g_enregistreur = NULL;
+static const EtatJeu* g_cible = NULL;
+
+void controleur_definir_enregistreur(Enregistreur* r, const EtatJeu* cible) {
+    g_enregistreur = r;
+    g_cible = r ? cible : NULL;
+}
+
 /* Applique la commande `c` sur l'état `e`. Ne fait rien si `e` est NULL. */
 void controleur_appliquer_commande(EtatJeu* e, Commande c) {
     if (!e) return;
+    if (g_enregistreur && e == g_cible) rejeu_enregistrer_commande(g_enregistreur, e, c);
     switch (c) {
         case CMD_GAUCHE:
             /* Déplace le vaisseau vers la gauche */
@@ -33,7 +44,50 @@ void controleur_appliquer_commande(EtatJeu* e, Commande c) {
             /* Demande au modèle de signaler la fin du jeu */
             _etatjeu_definir_quitter(e, 1);
             break;
+        case CMD_RECOMMENCER:
+            /* Repart de l'état initial, avec une graine tirée de la partie en cours */
+            etatjeu_reinitialiser(e);
+            break;
         default:
             break;
     }
 }
+
+void controleur_entrees_image(EntreesTick* t, unsigned vues) {
+    if (!t) return;
+    t->appuyees |= vues & ~t->maintenues;
+    t->maintenues = vues;
+}
+
+void controleur_entrees_vider(EntreesTick* t) {
+    if (!t) return;
+    t->maintenues = 0;
+    t->appuyees = 0;
+}
+
+/* Une touche : action à l'appui, puis toutes les `repetition` ticks tant qu'elle est maintenue */
+static int touche_agit(const EntreesTick* t, unsigned bit, int* attente, int repetition) {
+    if (t->appuyees & bit) {
+        *attente = 0;
+        return 1;
+    }
+    if (!(t->maintenues & bit)) return 0;
+    if (++*attente < repetition) return 0;
+    *attente = 0;
+    return 1;
+}
+
+/* Appelé par le modèle au début de chaque tick */
+static void appliquer_entrees(EtatJeu* e, void* contexte) {
+    EntreesTick* t = (EntreesTick*)contexte;
+    if (touche_agit(t, ENTREE_GAUCHE, &t->attente_gauche, REPETITION_DEPLACEMENT)) controleur_appliquer_commande(e, CMD_GAUCHE);
+    if (touche_agit(t, ENTREE_DROITE, &t->attente_droite, REPETITION_DEPLACEMENT)) controleur_appliquer_commande(e, CMD_DROITE);
+    if (touche_agit(t, ENTREE_TIRER, &t->attente_tir, REPETITION_TIR)) controleur_appliquer_commande(e, CMD_TIRER);
+    t->appuyees = 0;
+}
+
+int controleur_avancer(EtatJeu* e, EntreesTick* t, double dt_reel) {
+    if (!e) return 0;
+    if (!t) return etatjeu_avancer(e, dt_reel);
+    return etatjeu_avancer_avec(e, dt_reel, appliquer_entrees, t);
+}
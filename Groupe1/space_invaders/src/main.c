@@ -1,15 +1,22 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "model.h"
 #include "view_console.h"
 #include "view_sdl.h"
+#include "view_ansi.h"
 #include "view_menu.h"
+#include "view_headless.h"
+#include "batch.h"
 #include "highscores.h"
+#include "sauvegarde.h"
+#include "rejeu.h"
+#include "controller.h"
 
 /* Programme principal
- * - Parse les arguments de la ligne de commande pour choisir la vue (--view=console|sdl)
+ * - Parse les arguments de la ligne de commande pour choisir la vue (--view=console|sdl|ansi|headless|batch)
  * - Crée l'état du jeu
  * - Lance la boucle de la vue choisie
  * - Détruit l'état du jeu et retourne un code de sortie
@@ -23,8 +30,139 @@ int main(int argc, char** argv) {
      * strncmp permet de comparer les premiers 7 caractères.
      * Si correspondance, view pointe vers la sous-chaîne après "--view=".
      */
+    /* Options du mode headless : --ticks=N, --games=N, --policy=random|script|idle,
+     * --script=..., --seed=N, --kernels=N (banc des noyaux vectorisés),
+     * --collisions=N (banc de la grille d'occupation), --snapshots (banc de sauvegarde) */
+    ConfigHeadless config_headless;
+    vue_headless_config_defaut(&config_headless);
+    int ticks_donnes = 0;
+    int graine_donnee = 0;
+    int entites_noyaux = 0;
+    int entites_collisions = 0;
+    int banc_sauvegarde = 0;
+
+    /* Sauvegarde des parties console / SDL : --load=FICHIER reprend une partie
+     * sauvegardée, --save=FICHIER sauvegarde la partie quittée en cours de jeu */
+    const char* chemin_chargement = NULL;
+    const char* chemin_sauvegarde = NULL;
+
+    /* Rejeu : --record=FICHIER enregistre les commandes (console, SDL, headless ;
+     * en console et SDL, la n-ième partie lancée du menu va dans FICHIER.n),
+     * --keyframes=N espace les images clés, --replay=FICHIER rejoue sans limite
+     * de vitesse, --from=TICK commence à l'image clé précédant TICK */
+    const char* chemin_enregistrement = NULL;
+    int intervalle_images = REJEU_INTERVALLE_DEFAUT;
+    ConfigRejeu config_rejeu = { NULL, 0, 0 };
+
+    /* Configuration de la partie, pour toutes les vues : --width=N, --height=N,
+     * --rows=N, --cols=N (vague), --max-enemies=N, --max-bullets=N, --max-particles=N,
+     * --fire=random|aimed|burst|cycle (choix du tireur ennemi) */
+    ConfigJeu config_jeu;
+    etatjeu_config_defaut(&config_jeu);
+
+    /* Rendu du terrain de la vue SDL : --sdl-render=rects|texture,
+     * --cell-pixels=N (côté d'une case dans la texture) */
+    int rendu_sdl = RENDU_SDL_RECTANGLES;
+    int pixels_case = 1;
+
+    /* Options du mode batch : --threads=N, --scaling (et --games, --policy, --script, --seed) */
+    ConfigBatch config_batch;
+    batch_config_defaut(&config_batch);
+    int echelle = 0;
+
     for (int i = 1; i < argc; ++i) {
         if (strncmp(argv[i], "--view=", 7) == 0) view = argv[i] + 7;
+        else if (strncmp(argv[i], "--ticks=", 8) == 0) { config_headless.ticks_max = strtol(argv[i] + 8, NULL, 10); ticks_donnes = 1; }
+        else if (strncmp(argv[i], "--games=", 8) == 0) config_headless.parties_max = strtol(argv[i] + 8, NULL, 10);
+        else if (strncmp(argv[i], "--width=", 8) == 0) config_jeu.largeur = atoi(argv[i] + 8);
+        else if (strncmp(argv[i], "--height=", 9) == 0) config_jeu.hauteur = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--rows=", 7) == 0) config_jeu.vague_lignes = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--cols=", 7) == 0) config_jeu.vague_colonnes = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--max-enemies=", 14) == 0) config_jeu.max_ennemis = atoi(argv[i] + 14);
+        else if (strncmp(argv[i], "--max-bullets=", 14) == 0) config_jeu.max_projectiles = atoi(argv[i] + 14);
+        else if (strncmp(argv[i], "--max-particles=", 16) == 0) config_jeu.max_particules = atoi(argv[i] + 16);
+        else if (strncmp(argv[i], "--fire=", 7) == 0) {
+            int t = etatjeu_politique_tir_depuis_nom(argv[i] + 7);
+            if (t < 0) {
+                fprintf(stderr, "Politique de tir inconnue '%s'\n", argv[i] + 7);
+                return 2;
+            }
+            config_jeu.politique_tir = t;
+        }
+        else if (strncmp(argv[i], "--sdl-render=", 13) == 0) {
+            if (strcmp(argv[i] + 13, "rects") == 0) rendu_sdl = RENDU_SDL_RECTANGLES;
+            else if (strcmp(argv[i] + 13, "texture") == 0) rendu_sdl = RENDU_SDL_TEXTURE;
+            else {
+                fprintf(stderr, "Rendu SDL inconnu '%s'\n", argv[i] + 13);
+                return 2;
+            }
+        }
+        else if (strncmp(argv[i], "--cell-pixels=", 14) == 0) pixels_case = atoi(argv[i] + 14);
+        else if (strncmp(argv[i], "--kernels=", 10) == 0) entites_noyaux = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--collisions=", 13) == 0) entites_collisions = atoi(argv[i] + 13);
+        else if (strncmp(argv[i], "--threads=", 10) == 0) config_batch.nb_threads = atoi(argv[i] + 10);
+        else if (strcmp(argv[i], "--scaling") == 0) echelle = 1;
+        else if (strcmp(argv[i], "--snapshots") == 0) banc_sauvegarde = 1;
+        else if (strncmp(argv[i], "--load=", 7) == 0) chemin_chargement = argv[i] + 7;
+        else if (strncmp(argv[i], "--save=", 7) == 0) chemin_sauvegarde = argv[i] + 7;
+        else if (strncmp(argv[i], "--record=", 9) == 0) chemin_enregistrement = argv[i] + 9;
+        else if (strncmp(argv[i], "--keyframes=", 12) == 0) intervalle_images = atoi(argv[i] + 12);
+        else if (strncmp(argv[i], "--replay=", 9) == 0) config_rejeu.chemin = argv[i] + 9;
+        else if (strncmp(argv[i], "--from=", 7) == 0) config_rejeu.tick_depart = strtol(argv[i] + 7, NULL, 10);
+        else if (strncmp(argv[i], "--script=", 9) == 0) config_headless.script = argv[i] + 9;
+        else if (strncmp(argv[i], "--seed=", 7) == 0) { config_headless.graine = (unsigned int)strtoul(argv[i] + 7, NULL, 10); graine_donnee = 1; }
+        else if (strncmp(argv[i], "--policy=", 9) == 0) {
+            int p = politique_depuis_nom(argv[i] + 9);
+            if (p < 0) {
+                fprintf(stderr, "Politique inconnue '%s'\n", argv[i] + 9);
+                return 2;
+            }
+            config_headless.politique = (TypePolitique)p;
+        }
+    }
+
+    const char* erreur_config = etatjeu_config_erreur(&config_jeu);
+    if (erreur_config) {
+        fprintf(stderr, "Configuration de partie invalide : %s\n", erreur_config);
+        return 2;
+    }
+    config_headless.jeu = config_jeu;
+    config_headless.enregistrement = chemin_enregistrement;
+    config_headless.intervalle_images = intervalle_images;
+    config_batch.jeu = config_jeu;
+
+    /* Rejeu d'un enregistrement : la partie et sa configuration viennent du fichier */
+    if (config_rejeu.chemin) {
+        if (ticks_donnes) config_rejeu.ticks_max = config_headless.ticks_max;
+        return rejeu_executer(&config_rejeu);
+    }
+
+    /* Mode headless : pas de menu, pas de high-scores, uniquement le banc de mesure */
+    if (strcmp(view, "headless") == 0) {
+        if (entites_noyaux > 0) {
+            long iterations = ticks_donnes ? config_headless.ticks_max : 100000;
+            return vue_headless_noyaux(entites_noyaux, iterations);
+        }
+        if (entites_collisions > 0) {
+            long iterations = ticks_donnes ? config_headless.ticks_max : 1000;
+            return vue_headless_collisions(entites_collisions, iterations);
+        }
+        if (banc_sauvegarde) {
+            long iterations = ticks_donnes ? config_headless.ticks_max : 100000;
+            return vue_headless_sauvegarde(&config_headless, iterations);
+        }
+        /* --games seul : on s'arrête au nombre de parties, pas au nombre de ticks */
+        if (config_headless.parties_max > 0 && !ticks_donnes) config_headless.ticks_max = 0;
+        return vue_headless_executer(&config_headless);
+    }
+
+    /* Mode batch : parties indépendantes réparties sur un pool de threads */
+    if (strcmp(view, "batch") == 0) {
+        if (config_headless.parties_max > 0) config_batch.nb_parties = config_headless.parties_max;
+        config_batch.politique = config_headless.politique;
+        config_batch.script = config_headless.script;
+        config_batch.graine = config_headless.graine;
+        return vue_batch_executer(&config_batch, echelle);
     }
 
     /* Charger les meilleurs scores */
@@ -36,6 +174,28 @@ int main(int argc, char** argv) {
 
     int rc = 0; /* Code de retour */
     int continuer_jeu = 1;
+    int parties_jouees = 0;
+
+    /* Vue SDL : fenêtre et renderer ouverts une fois, partagés par les menus et les parties */
+    ContexteSDL* contexte_sdl = NULL;
+    if (strcmp(view, "sdl") == 0) {
+        contexte_sdl = vue_sdl_ouvrir();
+        if (!contexte_sdl) {
+            rc = 1;
+            continuer_jeu = 0;
+        }
+        vue_sdl_definir_rendu(contexte_sdl, rendu_sdl, pixels_case);
+    }
+
+    /* Vue console : terminal initialisé une fois, session partagée par les menus et les parties */
+    ContexteConsole* contexte_console = NULL;
+    if (strcmp(view, "console") == 0) {
+        contexte_console = vue_console_ouvrir();
+        if (!contexte_console) {
+            rc = 1;
+            continuer_jeu = 0;
+        }
+    }
 
     /* Boucle principale du menu */
     while (continuer_jeu) {
@@ -43,9 +203,12 @@ int main(int argc, char** argv) {
         
         /* Afficher le menu principal */
         if (strcmp(view, "console") == 0) {
-            choix_menu = vue_console_menu_principal();
+            choix_menu = vue_console_menu_principal(contexte_console);
         } else if (strcmp(view, "sdl") == 0) {
-            choix_menu = vue_sdl_menu_principal();
+            choix_menu = vue_sdl_menu_principal(contexte_sdl);
+        } else if (strcmp(view, "ansi") == 0) {
+            /* vue ANSI : pas de menu, une seule partie */
+            choix_menu = parties_jouees == 0 ? MENU_JOUER : MENU_QUITTER;
         } else {
             fprintf(stderr, "Vue inconnue '%s'\n", view);
             rc = 2;
@@ -54,30 +217,73 @@ int main(int argc, char** argv) {
 
         /* Traiter le choix du menu */
         if (choix_menu == MENU_JOUER) {
-            /* Créer l'état du jeu */
-            EtatJeu* e = etatjeu_creer(80, 24);
+            /* Créer l'état du jeu (--seed=N : partie reproductible), ou le
+             * reprendre depuis --load (la configuration vient alors du fichier) */
+            EtatJeu* e;
+            if (chemin_chargement) {
+                e = sauvegarde_charger(chemin_chargement);
+                if (!e) fprintf(stderr, "Sauvegarde illisible ou invalide '%s'\n", chemin_chargement);
+                chemin_chargement = NULL; /* les parties suivantes repartent de zéro */
+            } else {
+                uint64_t graine = graine_donnee ? config_headless.graine : (uint64_t)time(NULL);
+                e = etatjeu_creer_config(&config_jeu, graine);
+            }
             if (!e) {
                 fprintf(stderr, "Échec de création de l'état du jeu\n");
                 rc = 1;
                 break;
             }
 
+            /* Enregistrer les commandes de la partie (--record) : la première
+             * partie dans FICHIER, les suivantes dans FICHIER.2, FICHIER.3...
+             * pour ne pas écraser les précédentes */
+            Enregistreur* enregistreur = NULL;
+            char* chemin_partie = NULL;
+            if (chemin_enregistrement) {
+                size_t taille = strlen(chemin_enregistrement) + 16;
+                chemin_partie = (char*)malloc(taille);
+                if (chemin_partie) {
+                    if (parties_jouees == 0) snprintf(chemin_partie, taille, "%s", chemin_enregistrement);
+                    else snprintf(chemin_partie, taille, "%s.%d", chemin_enregistrement, parties_jouees + 1);
+                    enregistreur = rejeu_enregistrer_ouvrir(chemin_partie, e, intervalle_images);
+                }
+                if (!enregistreur) fprintf(stderr, "Impossible de créer le fichier de rejeu '%s'\n",
+                                           chemin_partie ? chemin_partie : chemin_enregistrement);
+                controleur_definir_enregistreur(enregistreur, e);
+            }
+
             /* Lancer la partie */
             if (strcmp(view, "console") == 0) {
-                rc = vue_console_executer(e);
+                rc = vue_console_executer(contexte_console, e);
             } else if (strcmp(view, "sdl") == 0) {
-                rc = vue_sdl_executer(e);
+                rc = vue_sdl_executer(contexte_sdl, e);
+            } else if (strcmp(view, "ansi") == 0) {
+                rc = vue_ansi_executer(e);
             }
+            parties_jouees += 1;
 
-            /* Vérifier si c'est un nouveau meilleur score */
+            if (enregistreur) {
+                controleur_definir_enregistreur(NULL, NULL);
+                if (rejeu_enregistrer_fermer(enregistreur, e) != 0)
+                    fprintf(stderr, "Écriture incomplète du fichier de rejeu '%s'\n", chemin_partie);
+            }
+            free(chemin_partie);
+
+            /* Partie quittée avant la fin : sauvegarde pour la reprendre avec --load */
+            if (chemin_sauvegarde && !etatjeu_est_game_over(e)) {
+                if (sauvegarde_ecrire(e, chemin_sauvegarde) != 0)
+                    fprintf(stderr, "Échec de la sauvegarde dans '%s'\n", chemin_sauvegarde);
+            }
+
+            /* Vérifier si c'est un nouveau meilleur score (la vue ANSI n'a pas de saisie de nom) */
             int score_final = etatjeu_obtenir_score(e);
-            if (highscores_est_top5(highscores, score_final)) {
+            if (strcmp(view, "ansi") != 0 && highscores_est_top5(highscores, score_final)) {
                 /* Demander le nom du joueur */
                 char* nom_joueur;
                 if (strcmp(view, "console") == 0) {
-                    nom_joueur = vue_console_saisir_nom(score_final, highscores);
+                    nom_joueur = vue_console_saisir_nom(contexte_console, score_final, highscores);
                 } else {
-                    nom_joueur = vue_sdl_saisir_nom(score_final, highscores);
+                    nom_joueur = vue_sdl_saisir_nom(contexte_sdl, score_final, highscores);
                 }
 
                 /* Insérer le score */
@@ -91,21 +297,24 @@ int main(int argc, char** argv) {
         } else if (choix_menu == MENU_VOIR_HIGHSCORES || choix_menu == MENU_HIGHSCORES) {
             /* Afficher les meilleurs scores */
             if (strcmp(view, "console") == 0) {
-                vue_console_afficher_highscores(highscores);
+                vue_console_afficher_highscores(contexte_console, highscores);
             } else if (strcmp(view, "sdl") == 0) {
-                vue_sdl_afficher_highscores(highscores);
+                vue_sdl_afficher_highscores(contexte_sdl, highscores);
             }
         } else if (choix_menu == MENU_OPTIONS) {
             if (strcmp(view, "sdl") == 0) {
-                vue_sdl_menu_options();
+                vue_sdl_menu_options(contexte_sdl);
             } else if (strcmp(view, "console") == 0) {
-                vue_console_menu_options();
+                vue_console_menu_options(contexte_console);
             }
         } else if (choix_menu == MENU_QUITTER) {
             continuer_jeu = 0;
         }
     }
 
+    vue_sdl_fermer(contexte_sdl);
+    vue_console_fermer(contexte_console);
+
     /* Libérer les meilleurs scores */
     highscores_detruire(highscores);
 
@@ -11,10 +11,12 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include "model.h"
+#include "model_noyaux.h"
 
 /* Structure de base : entité avec propriétés communes */
 typedef struct {
@@ -25,33 +27,92 @@ typedef struct {
     int type;  /* 0=joueur, 1=ennemi faible, 2=ennemi fort, 3=bouclier */
 } Entite;
 
-/* Particule d'explosion */
-typedef struct {
-    int x, y;
-    int vx, vy; /* vélocité */
-    int ttl;    /* time to live en frames */
-    int type;   /* type d'entité qui a explosé */
-} Particule;
-
 /* Constantes pour les types d'entités */
 #define TYPE_JOUEUR 0
 #define TYPE_ENNEMI_FAIBLE 1
 #define TYPE_ENNEMI_FORT 2
 #define TYPE_BOUCLIER 3
 
-#define NB_MAX_PARTICULES 256
+/*
+ * Projectiles et particules sont stockés en colonnes (structure de
+ * tableaux) avec des types étroits : chaque boucle de mise à jour ne lit
+ * que les champs dont elle a besoin, et les noyaux de `model_noyaux.c`
+ * traitent 8 à 16 entités par instruction. Les masques `actif` valent
+ * 0x00 ou MASQUE_VIVANT (0xFF).
+ *
+ * Projectiles et particules sont denses : les `nombre` premiers
+ * emplacements sont exactement les entités actives, et les emplacements
+ * suivants forment la réserve libre. Ajouter prend l'emplacement `nombre`,
+ * retirer recopie le dernier actif à la place du retiré : les deux sont en
+ * O(1) et les boucles ne parcourent que les entités actives.
+ *
+ * Les capacités sont fixées par `ConfigJeu` à la création : tous les
+ * tableaux sont découpés dans le même bloc mémoire que `struct EtatJeu`.
+ */
+/*
+ * La vague est une formation rigide : l'ennemi de la ligne r, colonne c
+ * (indice r * colonnes + c) est toujours en (VAGUE_X0 + decalage_x + c *
+ * espacement, VAGUE_Y0 + decalage_y + r * VAGUE_ESPACEMENT_Y). Sa position
+ * n'est pas stockée ; il ne reste par ennemi qu'un bit de vie, sa santé et
+ * son type. Par colonne, `tireur` donne la ligne de l'ennemi vivant le plus
+ * bas : c'est le seul qui peut tirer, et une colonne est vide quand il vaut
+ * -1. Tenus à jour à chaque mort avec les comptes de vivants par ligne, ils
+ * donnent les colonnes extrêmes et la ligne la plus basse : la marche, le
+ * test de bord, la fin de vague, la défaite et le choix du tireur sont en
+ * O(1), et les morts déplacent les extrêmes en O(lignes + colonnes) sur
+ * toute la vague.
+ */
+typedef struct {
+    uint64_t* vivants;        /* un bit par emplacement : `mots_par_ligne` mots par ligne de la vague */
+    uint8_t* sante;           /* points de vie, par emplacement */
+    uint8_t* type;            /* TYPE_ENNEMI_FAIBLE ou TYPE_ENNEMI_FORT */
+    int32_t* tireur;          /* par colonne : ligne du vivant le plus bas, -1 si la colonne est vide */
+    int32_t* colonnes_tir;    /* les `nb_colonnes_tir` colonnes non vides, dans un ordre quelconque */
+    int32_t* rang_colonne;    /* position d'une colonne non vide dans `colonnes_tir` */
+    int32_t* vivants_ligne;   /* ennemis vivants par ligne */
+    int nb_colonnes_tir;
+    int lignes, colonnes, mots_par_ligne;
+    int nombre;               /* emplacements de la vague (lignes x colonnes, tronqué à la capacité) */
+    int capacite;
+    int espacement;           /* pas horizontal entre deux colonnes */
+    int decalage_x;           /* déplacement de la formation depuis l'apparition de la vague */
+    int decalage_y;
+    int vivants_total;
+    int colonne_min, colonne_max; /* colonnes extrêmes encore vivantes (si vivants_total > 0) */
+    int ligne_max;            /* ligne vivante la plus basse */
+    int politique;            /* TIR_ALEATOIRE, TIR_VISE ou TIR_RAFALE pour cette vague */
+    int rafale_colonne;       /* rafale en cours : colonne qui tire, */
+    int rafale_restante;      /* tirs restants */
+    int rafale_attente;       /* et ticks avant le suivant */
+} Formation;
+
+/* Une rafale : RAFALE_TIRS tirs de la même colonne, à RAFALE_INTERVALLE ticks d'écart */
+#define RAFALE_TIRS 3
+#define RAFALE_INTERVALLE 8
 
-/* Structures internes spécialisées */
 typedef struct {
-    Entite entite;
-} Ennemi;
+    int16_t* x;
+    int16_t* y;
+    int16_t* dy;          /* -1 vers le haut, +1 vers le bas */
+    uint8_t* proprietaire; /* 0 = joueur, 1 = ennemi */
+    uint8_t* actif;       /* effacé par le noyau quand le tir sort du terrain */
+    int nombre; /* nombre de projectiles actifs */
+    int capacite;
+    int deplaces; /* les `deplaces` premiers ont avancé de dy au dernier tick, les suivants sont nouveaux */
+} Projectiles;
 
+/* Particules d'explosion (vivantes tant que ttl > 0) */
 typedef struct {
-    int x, y;
-    int dy; /* -1 vers le haut, +1 vers le bas */
-    int proprietaire; /* 0 = joueur, 1 = ennemi */
-    int actif;
-} Projectile;
+    int16_t* x;
+    int16_t* y;
+    int16_t* vx; /* vélocité */
+    int16_t* vy;
+    int16_t* ttl; /* time to live en frames */
+    uint8_t* type; /* type d'entité qui a explosé */
+    int nombre; /* nombre de particules vivantes */
+    int capacite;
+    int deplaces; /* les `deplaces` premières ont avancé de (vx, vy) au dernier tick */
+} Particules;
 
 typedef struct {
     Entite entite;
@@ -63,6 +124,7 @@ typedef struct {
 
 /* Etat interne du jeu */
 struct EtatJeu {
+    ConfigJeu config;
     int largeur;
     int hauteur;
     Joueur joueur;
@@ -70,47 +132,122 @@ struct EtatJeu {
     int score;
     int niveau;
     double temps_acc;
+    uint64_t tick; /* ticks exécutés depuis le début de la partie */
+    double acc_pas; /* temps réel reçu par etatjeu_avancer, pas encore simulé */
     int quitter;
     int game_over; /* 1 si le joueur est mort */
 
     /* ennemis / projectiles */
-    Ennemi ennemis[NB_MAX_ENNEMIS];
-    int nombre_ennemis;
+    Formation formation;
     int direction_ennemis; /* +1 droite, -1 gauche */
     double acc_deplacement_ennemis;
     double intervalle_deplacement_ennemis;
 
-    Projectile projectiles[NB_MAX_PROJECTILES];
-    int nombre_projectiles;
-    
+    Projectiles projectiles;
+
     /* boucliers */
     Bouclier boucliers[NB_MAX_BOUCLIERS];
     int nombre_boucliers;
-    
+
     /* particules d'explosion */
-    Particule particules[NB_MAX_PARTICULES];
-    int nombre_particules;
+    Particules particules;
+
+    /* grille d'occupation des boucliers : un tir ne teste que sa case */
+    Grille grille_boucliers;
+    int marche_dx; /* déplacement de la formation au dernier tick */
+    int marche_dy;
+
+    /* anneau d'événements : l'événement numéro n est dans la case
+     * n % EVENEMENTS_CAPACITE ; `evenements_ecrits` ne fait que croître */
+    Evenement evenements[EVENEMENTS_CAPACITE];
+    uint64_t evenements_ecrits;
+
+    /* calque de rendu (voir etatjeu_calque_actualiser) : alloué au premier
+     * appel, dans un bloc à part, seulement pour les parties qui ont une vue */
+    unsigned char* calque_bloc;
+    uint8_t* calque;              /* code CASE_* par case */
+    int32_t* calque_occupees;     /* cases non vides du calque */
+    int32_t* calque_nouvelles;    /* cases posées pendant l'actualisation en cours */
+    uint8_t* calque_anciens;      /* code de chaque case de `calque_occupees` avant l'actualisation */
+    int nb_occupees;
+    int nb_nouvelles;
+    Grille grille_modifiee;       /* cases modifiées depuis le dernier acquittement */
+    uint64_t* lignes_modifiees;   /* un bit par ligne ayant au moins une case modifiée */
+    long cases_modifiees;
+
+    /* générateur pseudo-aléatoire propre à la partie (xorshift64*) :
+     * aucun état global, plusieurs parties peuvent tourner en parallèle */
+    uint64_t graine; /* graine de la partie en cours ; etatjeu_reinitialiser en tire une nouvelle de `alea` */
+    uint64_t alea;
 };
 
+/* Tire un entier dans [0, borne) avec le générateur de la partie */
+static int alea_borne(EtatJeu* e, int borne) {
+    uint64_t x = e->alea;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    e->alea = x;
+    uint32_t r = (uint32_t)((x * 0x2545F4914F6CDD1Dull) >> 32);
+    return (int)(((uint64_t)r * (uint64_t)borne) >> 32);
+}
+
+/* Mélange splitmix64 : transforme une graine quelconque en état non nul */
+static uint64_t melanger_graine(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return z ? z : 0x9E3779B97F4A7C15ull;
+}
+
 /* Ligne logique du vaisseau (utilisée pour collisions et condition de défaite) */
 static int ligne_vaisseau(const EtatJeu* e) {
     return e ? e->hauteur - 2 : 0;
 }
 
+/* Ajoute un événement à l'anneau, en écrasant le plus ancien s'il est plein */
+static void emettre(EtatJeu* e, TypeEvenement type, int x, int y, int detail, int valeur) {
+    Evenement* ev = &e->evenements[e->evenements_ecrits & (EVENEMENTS_CAPACITE - 1)];
+    ev->tick = e->tick;
+    ev->valeur = valeur;
+    ev->x = (int16_t)x;
+    ev->y = (int16_t)y;
+    ev->type = (uint8_t)type;
+    ev->detail = (uint8_t)detail;
+    e->evenements_ecrits += 1;
+}
+
 /* Ajoute un projectile au tableau interne si possible. */
 static void ajouter_projectile(EtatJeu* e, int x, int y, int dy, int proprietaire) {
-    if (!e) return;
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) {
-        if (!e->projectiles[i].actif) {
-            e->projectiles[i].actif = 1;
-            e->projectiles[i].x = x;
-            e->projectiles[i].y = y;
-            e->projectiles[i].dy = dy;
-            e->projectiles[i].proprietaire = proprietaire;
-            if (i >= e->nombre_projectiles) e->nombre_projectiles = i+1;
-            return;
-        }
-    }
+    if (!e || e->projectiles.nombre >= e->projectiles.capacite) return;
+    int i = e->projectiles.nombre++;
+    e->projectiles.actif[i] = MASQUE_VIVANT;
+    e->projectiles.x[i] = (int16_t)x;
+    e->projectiles.y[i] = (int16_t)y;
+    e->projectiles.dy[i] = (int16_t)dy;
+    e->projectiles.proprietaire[i] = (uint8_t)proprietaire;
+}
+
+/* Retire le projectile i en le remplaçant par le dernier actif (l'ordre n'est pas conservé) */
+static void retirer_projectile(Projectiles* p, int i) {
+    int dernier = --p->nombre;
+    p->x[i] = p->x[dernier];
+    p->y[i] = p->y[dernier];
+    p->dy[i] = p->dy[dernier];
+    p->proprietaire[i] = p->proprietaire[dernier];
+    p->actif[i] = p->actif[dernier];
+}
+
+/* Retire la particule i en la remplaçant par la dernière vivante */
+static void retirer_particule(Particules* p, int i) {
+    int dernier = --p->nombre;
+    p->x[i] = p->x[dernier];
+    p->y[i] = p->y[dernier];
+    p->vx[i] = p->vx[dernier];
+    p->vy[i] = p->vy[dernier];
+    p->ttl[i] = p->ttl[dernier];
+    p->type[i] = p->type[dernier];
 }
 
 /* Crée une explosion à une position avec des particules */
@@ -121,32 +258,171 @@ static void creer_explosion(EtatJeu* e, int x, int y, int type) {
         {1, 0}, {-1, 0}, {0, 1}, {0, -1},
         {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
     };
-    for (int i = 0; i < 8 && e->nombre_particules < NB_MAX_PARTICULES; ++i) {
-        int idx = -1;
-        for (int j = 0; j < NB_MAX_PARTICULES; ++j) {
-            if (e->particules[j].ttl <= 0) {
-                idx = j;
-                break;
+    for (int i = 0; i < 8 && e->particules.nombre < e->particules.capacite; ++i) {
+        int idx = e->particules.nombre++;
+        e->particules.x[idx] = (int16_t)x;
+        e->particules.y[idx] = (int16_t)y;
+        e->particules.vx[idx] = (int16_t)(directions[i][0] * 2);
+        e->particules.vy[idx] = (int16_t)(directions[i][1] * 2);
+        e->particules.ttl[idx] = 20; /* 20 frames de vie */
+        e->particules.type[idx] = (uint8_t)type;
+    }
+}
+
+/* Origine et pas vertical de la vague ; le pas horizontal dépend de la largeur */
+#define VAGUE_X0 2
+#define VAGUE_Y0 2
+#define VAGUE_ESPACEMENT_Y 2
+
+static int espacement_vague(int largeur, int colonnes) {
+    int espacement_x = (largeur - 4) / colonnes;
+    return espacement_x < 2 ? 2 : espacement_x;
+}
+
+/* Nombre d'ennemis d'une vague complète (une vague plus grande que la capacité est tronquée) */
+static int ennemis_par_vague(const ConfigJeu* c) {
+    long n = (long)c->vague_lignes * c->vague_colonnes;
+    return n < c->max_ennemis ? (int)n : c->max_ennemis;
+}
+
+/* Case de l'emplacement (r, c) de la formation */
+static int formation_x(const Formation* f, int c) {
+    return VAGUE_X0 + f->decalage_x + c * f->espacement;
+}
+
+static int formation_y(const Formation* f, int r) {
+    return VAGUE_Y0 + f->decalage_y + r * VAGUE_ESPACEMENT_Y;
+}
+
+/* Mot du masque de vie qui contient la colonne c de la ligne r */
+static uint64_t* formation_mot(const Formation* f, int r, int c) {
+    return &f->vivants[(size_t)r * (size_t)f->mots_par_ligne + (size_t)(c >> 6)];
+}
+
+static int formation_vivant(const Formation* f, int r, int c) {
+    return (int)((*formation_mot(f, r, c) >> (c & 63)) & 1u);
+}
+
+/* Emplacement d'un ennemi vivant sur la case (x, y). @return son indice, -1 s'il n'y en a pas */
+static int formation_emplacement(const Formation* f, int x, int y) {
+    if (f->vivants_total == 0) return -1;
+    int dy = y - formation_y(f, 0);
+    if (dy < 0 || dy % VAGUE_ESPACEMENT_Y != 0 || dy / VAGUE_ESPACEMENT_Y > f->ligne_max) return -1;
+    int dx = x - formation_x(f, 0);
+    if (dx < 0 || dx % f->espacement != 0 || dx / f->espacement > f->colonne_max) return -1;
+    int r = dy / VAGUE_ESPACEMENT_Y, c = dx / f->espacement;
+    return formation_vivant(f, r, c) ? r * f->colonnes + c : -1;
+}
+
+/* Retire l'ennemi (r, c). Si c'était le tireur de sa colonne, le vivant
+ * au-dessus le remplace ; une colonne vidée quitte la liste des colonnes de
+ * tir et resserre les colonnes extrêmes. */
+static void formation_tuer(Formation* f, int r, int c) {
+    *formation_mot(f, r, c) &= ~((uint64_t)1 << (c & 63));
+    f->vivants_total -= 1;
+    f->vivants_ligne[r] -= 1;
+    if (f->tireur[c] == r) {
+        int t = r - 1;
+        while (t >= 0 && !formation_vivant(f, t, c)) --t;
+        f->tireur[c] = t;
+        if (t < 0) {
+            /* la dernière colonne de la liste prend la place de la colonne vidée */
+            int rang = f->rang_colonne[c];
+            int derniere = f->colonnes_tir[--f->nb_colonnes_tir];
+            f->colonnes_tir[rang] = derniere;
+            f->rang_colonne[derniere] = rang;
+        }
+    }
+    if (f->vivants_total == 0) return;
+    while (f->colonne_min < f->colonne_max && f->tireur[f->colonne_min] < 0) ++f->colonne_min;
+    while (f->colonne_max > f->colonne_min && f->tireur[f->colonne_max] < 0) --f->colonne_max;
+    while (f->ligne_max > 0 && f->vivants_ligne[f->ligne_max] <= 0) --f->ligne_max;
+}
+
+/* Colonne non vide la plus proche de la case x (à égalité, celle de gauche).
+ * Les colonnes extrêmes sont non vides : la recherche s'arrête avant elles. */
+static int formation_colonne_proche(const Formation* f, int x) {
+    int dx = x - formation_x(f, 0);
+    int c = dx <= 0 ? 0 : (dx + f->espacement / 2) / f->espacement;
+    if (c < f->colonne_min) c = f->colonne_min;
+    if (c > f->colonne_max) c = f->colonne_max;
+    for (int d = 0; d <= f->colonne_max - f->colonne_min; ++d) {
+        if (c - d >= f->colonne_min && f->tireur[c - d] >= 0) return c - d;
+        if (c + d <= f->colonne_max && f->tireur[c + d] >= 0) return c + d;
+    }
+    return f->colonnes_tir[0];
+}
+
+/* Place une nouvelle vague d'ennemis en grille (config.vague_lignes x
+ * config.vague_colonnes) selon le niveau courant. L'ennemi de la ligne r,
+ * colonne c reçoit l'indice r * colonnes + c. */
+static void generer_vague(EtatJeu* e) {
+    Formation* f = &e->formation;
+    f->nombre = ennemis_par_vague(&e->config);
+    f->decalage_x = 0;
+    f->decalage_y = 0;
+    memset(f->vivants, 0, (size_t)f->lignes * (size_t)f->mots_par_ligne * sizeof(uint64_t));
+    memset(f->vivants_ligne, 0, (size_t)f->lignes * sizeof(int32_t));
+    int idx = 0;
+    for (int r = 0; r < f->lignes && idx < f->nombre; ++r) {
+        for (int c = 0; c < f->colonnes && idx < f->nombre; ++c, ++idx) {
+            *formation_mot(f, r, c) |= (uint64_t)1 << (c & 63);
+            f->tireur[c] = r;
+            f->vivants_ligne[r] += 1;
+            /* Santé basée sur le niveau : niveau 1=1, niveau 2+=1 ou 2 */
+            f->sante[idx] = 1;
+            f->type[idx] = TYPE_ENNEMI_FAIBLE;
+            if (e->niveau >= 2) {
+                /* 25% des ennemis ont 2 de santé au niveau 2, plus au niveau 3+ */
+                int pourcentage = 25 + (e->niveau - 2) * 15; /* 25, 40, 55... % */
+                if (alea_borne(e, 100) < pourcentage) {
+                    f->sante[idx] = 2;
+                    f->type[idx] = TYPE_ENNEMI_FORT;
+                }
             }
         }
-        if (idx == -1) continue;
-        e->particules[idx].x = x;
-        e->particules[idx].y = y;
-        e->particules[idx].vx = directions[i][0] * 2;
-        e->particules[idx].vy = directions[i][1] * 2;
-        e->particules[idx].ttl = 20; /* 20 frames de vie */
-        e->particules[idx].type = type;
-        if (idx >= e->nombre_particules) e->nombre_particules = idx + 1;
     }
+    f->vivants_total = f->nombre;
+    f->colonne_min = 0;
+    f->colonne_max = f->nombre < f->colonnes ? f->nombre - 1 : f->colonnes - 1;
+    f->ligne_max = (f->nombre - 1) / f->colonnes;
+    f->nb_colonnes_tir = f->colonne_max + 1;
+    for (int c = 0; c < f->colonnes; ++c) {
+        if (c >= f->nb_colonnes_tir) f->tireur[c] = -1;
+        f->colonnes_tir[c] = c;
+        f->rang_colonne[c] = c;
+    }
+
+    int politique = e->config.politique_tir;
+    f->politique = politique == TIR_ALTERNE ? (e->niveau - 1) % TIR_ALTERNE : politique;
+    f->rafale_colonne = 0;
+    f->rafale_restante = 0;
+    f->rafale_attente = 0;
 }
 
-EtatJeu* etatjeu_creer(int largeur, int hauteur) {
-    EtatJeu* e = (EtatJeu*)malloc(sizeof(EtatJeu));
-    if (!e) return NULL;
-    e->largeur = largeur;
-    e->hauteur = hauteur;
-    e->joueur.entite.x = largeur / 2;
-    e->joueur.entite.y = hauteur - 1;
+/* Le tireur de la colonne c tire vers le bas */
+static void formation_tirer(EtatJeu* e, int c) {
+    const Formation* f = &e->formation;
+    ajouter_projectile(e, formation_x(f, c), formation_y(f, f->tireur[c]) + 1, +1, 1);
+}
+
+/* Place les boucliers sur leurs cases fixes (réparties sur la largeur, à mi-hauteur) */
+static void placer_boucliers(EtatJeu* e) {
+    e->nombre_boucliers = NB_MAX_BOUCLIERS;
+    int espacement_boucliers = e->largeur / 5;
+    for (int i = 0; i < NB_MAX_BOUCLIERS; ++i) {
+        e->boucliers[i].entite.x = espacement_boucliers * (i + 1);
+        e->boucliers[i].entite.y = e->hauteur / 2;
+        e->boucliers[i].entite.dmg = 0; /* les boucliers ne font pas de dégâts */
+        e->boucliers[i].entite.type = TYPE_BOUCLIER;
+    }
+}
+
+/* Remet la partie dans son état initial, générateur aléatoire compris :
+ * deux parties de même graine et mêmes entrées restent identiques. */
+static void initialiser_partie(EtatJeu* e) {
+    e->joueur.entite.x = e->largeur / 2;
+    e->joueur.entite.y = e->hauteur - 1;
     e->joueur.entite.vivant = 1;
     e->joueur.entite.sante = 1;
     e->joueur.entite.dmg = 1;
@@ -155,224 +431,380 @@ EtatJeu* etatjeu_creer(int largeur, int hauteur) {
     e->score = 0;
     e->niveau = 1;
     e->temps_acc = 0.0;
+    e->tick = 0;
+    e->acc_pas = 0.0;
+    e->marche_dx = 0;
+    e->marche_dy = 0;
     e->quitter = 0;
     e->game_over = 0;
 
+    e->alea = melanger_graine(e->graine);
+
     /* initialisation des ennemis en grille simple */
-    e->nombre_ennemis = 0;
     e->direction_ennemis = 1;
     e->acc_deplacement_ennemis = 0.0;
     e->intervalle_deplacement_ennemis = 0.6; /* secondes */
-    int lignes = 3;
-    int colonnes = 8;
-    int start_y = 2;
-    int espacement_x = (largeur - 4) / colonnes;
-    if (espacement_x < 2) espacement_x = 2;
-    for (int r = 0; r < lignes; ++r) {
-        for (int c = 0; c < colonnes; ++c) {
-            int idx = e->nombre_ennemis++;
-            if (idx >= NB_MAX_ENNEMIS) break;
-            e->ennemis[idx].entite.vivant = 1;
-            e->ennemis[idx].entite.x = 2 + c * espacement_x;
-            e->ennemis[idx].entite.y = start_y + r*2;
-            e->ennemis[idx].entite.dmg = 1;
-            /* Santé basée sur le niveau : niveau 1=1, niveau 2+=1 ou 2 */
-            e->ennemis[idx].entite.sante = 1;
-            e->ennemis[idx].entite.type = TYPE_ENNEMI_FAIBLE;
-            if (e->niveau >= 2) {
-                /* 25% des ennemis ont 2 de santé au niveau 2, plus au niveau 3+ */
-                int pourcentage = 25 + (e->niveau - 2) * 15; /* 25, 40, 55... % */
-                if (rand() % 100 < pourcentage) {
-                    e->ennemis[idx].entite.sante = 2;
-                    e->ennemis[idx].entite.type = TYPE_ENNEMI_FORT;
-                }
-            }
-        }
-    }
+    generer_vague(e);
 
-    /* initialisation des projectiles */
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) e->projectiles[i].actif = 0;
-    e->nombre_projectiles = 0;
+    /* initialisation des projectiles : réserve entièrement libre */
+    e->projectiles.nombre = 0;
+    e->projectiles.deplaces = 0;
 
-    /* initialisation des boucliers (4 positions) */
-    e->nombre_boucliers = 4;
-    int espacement_boucliers = largeur / 5;
+    /* initialisation des boucliers (positions posées par allouer_etat) */
+    grille_vider_lignes(&e->grille_boucliers, e->hauteur / 2, e->hauteur / 2);
     for (int i = 0; i < NB_MAX_BOUCLIERS; ++i) {
         e->boucliers[i].entite.vivant = 1;
-        e->boucliers[i].entite.x = espacement_boucliers * (i + 1);
-        e->boucliers[i].entite.y = hauteur / 2;
         e->boucliers[i].entite.sante = 3; /* 3 coups pour détruire */
-        e->boucliers[i].entite.dmg = 0; /* les boucliers ne font pas de dégâts */
-        e->boucliers[i].entite.type = TYPE_BOUCLIER;
+        grille_poser(&e->grille_boucliers, e->boucliers[i].entite.x, e->boucliers[i].entite.y);
     }
 
     /* initialisation des particules */
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) e->particules[i].ttl = 0;
-    e->nombre_particules = 0;
+    e->particules.nombre = 0;
+    e->particules.deplaces = 0;
+}
+
+void etatjeu_config_defaut(ConfigJeu* c) {
+    if (!c) return;
+    c->largeur = 80;
+    c->hauteur = 24;
+    c->vague_lignes = 3;
+    c->vague_colonnes = 8;
+    c->max_ennemis = NB_MAX_ENNEMIS;
+    c->max_projectiles = NB_MAX_PROJECTILES;
+    c->max_particules = NB_MAX_PARTICULES;
+    c->politique_tir = TIR_ALEATOIRE;
+}
+
+int etatjeu_politique_tir_depuis_nom(const char* nom) {
+    if (!nom) return -1;
+    if (strcmp(nom, "random") == 0) return TIR_ALEATOIRE;
+    if (strcmp(nom, "aimed") == 0) return TIR_VISE;
+    if (strcmp(nom, "burst") == 0) return TIR_RAFALE;
+    if (strcmp(nom, "cycle") == 0) return TIR_ALTERNE;
+    return -1;
+}
 
-    /* initialisation RNG pour tirs ennemis */
-    srand((unsigned int)time(NULL));
+const char* etatjeu_config_erreur(const ConfigJeu* c) {
+    if (!c) return "configuration absente";
+    if (c->largeur < CONFIG_LARGEUR_MIN || c->largeur > CONFIG_DIMENSION_MAX) return "largeur hors limites";
+    if (c->hauteur < CONFIG_HAUTEUR_MIN || c->hauteur > CONFIG_DIMENSION_MAX) return "hauteur hors limites";
+    if (c->vague_lignes < 1 || c->vague_colonnes < 1) return "vague vide";
+    if (c->vague_lignes > c->hauteur || c->vague_colonnes > c->largeur) return "vague plus grande que le terrain";
+    /* la vague doit tenir dans le terrain, au-dessus de la ligne du vaisseau */
+    if (VAGUE_X0 + (c->vague_colonnes - 1) * espacement_vague(c->largeur, c->vague_colonnes) >= c->largeur)
+        return "trop de colonnes d'ennemis pour la largeur";
+    if (VAGUE_Y0 + (c->vague_lignes - 1) * VAGUE_ESPACEMENT_Y >= c->hauteur - 2)
+        return "trop de lignes d'ennemis pour la hauteur";
+    if (c->max_ennemis < 1 || c->max_ennemis > CONFIG_CAPACITE_MAX) return "capacite d'ennemis hors limites";
+    if (c->max_projectiles < 1 || c->max_projectiles > CONFIG_CAPACITE_MAX) return "capacite de projectiles hors limites";
+    if (c->max_particules < 1 || c->max_particules > CONFIG_CAPACITE_MAX) return "capacite de particules hors limites";
+    if (c->politique_tir < TIR_ALEATOIRE || c->politique_tir > TIR_ALTERNE) return "politique de tir inconnue";
+    return NULL;
+}
+
+/* Réserve `taille` octets dans le bloc de l'état ; `curseur` avance d'autant,
+ * arrondi à 16 octets pour que chaque tableau commence aligné. */
+static size_t reserver(size_t* curseur, size_t taille) {
+    size_t debut = (*curseur + 15) & ~(size_t)15;
+    *curseur = debut + taille;
+    return debut;
+}
+
+/* Masque de vie, tireurs, colonnes de tir et leurs rangs, comptes par ligne,
+ * santé et type : les tableaux de la formation, contigus dans cet ordre dans
+ * l'état comme dans la sauvegarde, qui les copie d'un bloc */
+static size_t taille_formation(const ConfigJeu* c) {
+    return grille_nombre_mots(c->vague_colonnes, c->vague_lignes) * sizeof(uint64_t) +
+           (3 * (size_t)c->vague_colonnes + (size_t)c->vague_lignes) * sizeof(int32_t) +
+           (size_t)ennemis_par_vague(c) * 2;
+}
 
+/* Alloue l'état et tous ses tableaux en un seul bloc, dimensionné par la configuration */
+static EtatJeu* allouer_etat(const ConfigJeu* c) {
+    if (etatjeu_config_erreur(c)) return NULL;
+    size_t np = (size_t)c->max_projectiles, nq = (size_t)c->max_particules;
+    size_t mots = grille_nombre_mots(c->largeur, c->hauteur);
+    size_t mots_vague = grille_nombre_mots(c->vague_colonnes, c->vague_lignes);
+    size_t nc = (size_t)c->vague_colonnes, nl = (size_t)c->vague_lignes;
+
+    /* première passe : positions des tableaux dans le bloc */
+    size_t taille = sizeof(EtatJeu);
+    size_t o_f = reserver(&taille, taille_formation(c));
+    size_t o_px = reserver(&taille, np * sizeof(int16_t));
+    size_t o_py = reserver(&taille, np * sizeof(int16_t));
+    size_t o_pdy = reserver(&taille, np * sizeof(int16_t));
+    size_t o_pp = reserver(&taille, np);
+    size_t o_pa = reserver(&taille, np);
+    size_t o_qx = reserver(&taille, nq * sizeof(int16_t));
+    size_t o_qy = reserver(&taille, nq * sizeof(int16_t));
+    size_t o_qvx = reserver(&taille, nq * sizeof(int16_t));
+    size_t o_qvy = reserver(&taille, nq * sizeof(int16_t));
+    size_t o_qt = reserver(&taille, nq * sizeof(int16_t));
+    size_t o_qty = reserver(&taille, nq);
+    size_t o_gb = reserver(&taille, mots * sizeof(uint64_t));
+
+    unsigned char* bloc = (unsigned char*)calloc(1, taille);
+    if (!bloc) return NULL;
+    EtatJeu* e = (EtatJeu*)bloc;
+    e->config = *c;
+    e->largeur = c->largeur;
+    e->hauteur = c->hauteur;
+
+    Formation* f = &e->formation;
+    f->vivants = (uint64_t*)(bloc + o_f);
+    f->tireur = (int32_t*)(f->vivants + mots_vague);
+    f->colonnes_tir = f->tireur + nc;
+    f->rang_colonne = f->colonnes_tir + nc;
+    f->vivants_ligne = f->rang_colonne + nc;
+    f->sante = (uint8_t*)(f->vivants_ligne + nl);
+    f->type = f->sante + (size_t)ennemis_par_vague(c);
+    f->lignes = c->vague_lignes;
+    f->colonnes = c->vague_colonnes;
+    f->mots_par_ligne = (c->vague_colonnes + 63) / 64;
+    f->capacite = c->max_ennemis;
+    f->espacement = espacement_vague(c->largeur, c->vague_colonnes);
+
+    e->projectiles.x = (int16_t*)(bloc + o_px);
+    e->projectiles.y = (int16_t*)(bloc + o_py);
+    e->projectiles.dy = (int16_t*)(bloc + o_pdy);
+    e->projectiles.proprietaire = bloc + o_pp;
+    e->projectiles.actif = bloc + o_pa;
+    e->projectiles.capacite = c->max_projectiles;
+
+    e->particules.x = (int16_t*)(bloc + o_qx);
+    e->particules.y = (int16_t*)(bloc + o_qy);
+    e->particules.vx = (int16_t*)(bloc + o_qvx);
+    e->particules.vy = (int16_t*)(bloc + o_qvy);
+    e->particules.ttl = (int16_t*)(bloc + o_qt);
+    e->particules.type = bloc + o_qty;
+    e->particules.capacite = c->max_particules;
+
+    grille_lier(&e->grille_boucliers, (uint64_t*)(bloc + o_gb), c->largeur, c->hauteur);
+    placer_boucliers(e);
+    return e;
+}
+
+EtatJeu* etatjeu_creer_config(const ConfigJeu* c, uint64_t graine) {
+    EtatJeu* e = allouer_etat(c);
+    if (!e) return NULL;
+    e->graine = graine;
+    initialiser_partie(e);
+    return e;
+}
+
+EtatJeu* etatjeu_creer_avec_graine(int largeur, int hauteur, uint64_t graine) {
+    ConfigJeu c;
+    etatjeu_config_defaut(&c);
+    c.largeur = largeur;
+    c.hauteur = hauteur;
+    return etatjeu_creer_config(&c, graine);
+}
+
+EtatJeu* etatjeu_creer(int largeur, int hauteur) {
+    ConfigJeu c;
+    etatjeu_config_defaut(&c);
+    c.largeur = largeur;
+    c.hauteur = hauteur;
+    EtatJeu* e = allouer_etat(&c);
+    if (!e) return NULL;
+    /* graine non reproductible : l'adresse de l'état distingue deux parties
+     * créées dans la même seconde */
+    e->graine = (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)e;
+    initialiser_partie(e);
     return e;
 }
 
 void etatjeu_detruire(EtatJeu* e) {
     if (!e) return;
+    free(e->calque_bloc);
     free(e);
 }
 
-static int nombre_ennemis_vivants(EtatJeu* e) {
-    int c = 0;
-    for (int i = 0; i < e->nombre_ennemis; ++i) if (e->ennemis[i].entite.vivant) ++c;
-    return c;
+/* Touche un bouclier présent en (x, y). @return 1 si le projectile est absorbé */
+static int toucher_bouclier(EtatJeu* e, int x, int y) {
+    if (!grille_occupee(&e->grille_boucliers, x, y)) return 0;
+    for (int b = 0; b < e->nombre_boucliers; ++b) {
+        if (!e->boucliers[b].entite.vivant) continue;
+        if (e->boucliers[b].entite.x == x && e->boucliers[b].entite.y == y) {
+            e->boucliers[b].entite.sante -= 1;
+            emettre(e, EVT_BOUCLIER_TOUCHE, x, y, e->boucliers[b].entite.sante > 0 ? e->boucliers[b].entite.sante : 0, 0);
+            if (e->boucliers[b].entite.sante <= 0) {
+                creer_explosion(e, e->boucliers[b].entite.x, e->boucliers[b].entite.y, e->boucliers[b].entite.type);
+                e->boucliers[b].entite.vivant = 0;
+                grille_effacer(&e->grille_boucliers, x, y);
+            }
+            return 1;
+        }
+    }
+    return 0;
 }
 
 void etatjeu_mettre_a_jour(EtatJeu* e, double dt) {
     if (!e) return;
+    int etait_game_over = e->game_over;
     e->temps_acc += dt;
+    e->marche_dx = 0;
+    e->marche_dy = 0;
+
+    /* Mise à jour des particules d'explosion (noyau vectorisé) */
+    Particules* parts = &e->particules;
+    noyau_avancer_particules(parts->x, parts->y, parts->vx, parts->vy, parts->ttl, parts->nombre);
+    for (int i = 0; i < parts->nombre; ) {
+        if (parts->ttl[i] <= 0) retirer_particule(parts, i); /* la dernière prend sa place */
+        else ++i;
+    }
+    parts->deplaces = parts->nombre; /* les explosions de ce tick s'ajoutent après */
+
+    /* Déplacement des projectiles et suppression de ceux qui sortent du
+     * terrain (noyau vectorisé), puis collisions des projectiles restants.
+     * Les projectiles ne se percutent pas entre eux : avancer tout le monde
+     * avant de tester les collisions donne le même résultat qu'une seule passe.
+     * Un projectile retiré est remplacé par le dernier actif, qui n'a pas
+     * encore été traité : l'indice n'avance que si le projectile reste. */
+    Projectiles* projs = &e->projectiles;
+    Formation* f = &e->formation;
+    noyau_avancer_projectiles(projs->y, projs->dy, projs->actif, projs->nombre, e->hauteur);
 
-    /* Mise à jour des particules d'explosion */
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) {
-        if (e->particules[i].ttl <= 0) continue;
-        e->particules[i].x += e->particules[i].vx;
-        e->particules[i].y += e->particules[i].vy;
-        e->particules[i].ttl -= 1;
-    }
-
-    /* Déplacement des projectiles */
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) {
-        if (!e->projectiles[i].actif) continue;
-        e->projectiles[i].y += e->projectiles[i].dy;
-        /* hors limites */
-        if (e->projectiles[i].y < 0 || e->projectiles[i].y >= e->hauteur) {
-            e->projectiles[i].actif = 0;
+    for (int i = 0; i < projs->nombre; ) {
+        if (!projs->actif[i]) {
+            retirer_projectile(projs, i);
             continue;
         }
+        int px = projs->x[i];
+        int py = projs->y[i];
 
-        if (e->projectiles[i].proprietaire == 0) {
-            /* projectile joueur : collision avec ennemis */
-            for (int enn = 0; enn < e->nombre_ennemis; ++enn) {
-                if (!e->ennemis[enn].entite.vivant) continue;
-                if (e->ennemis[enn].entite.x == e->projectiles[i].x && e->ennemis[enn].entite.y == e->projectiles[i].y) {
-                    e->projectiles[i].actif = 0;
-                    e->ennemis[enn].entite.sante -= 1;
-                    if (e->ennemis[enn].entite.sante <= 0) {
-                        creer_explosion(e, e->ennemis[enn].entite.x, e->ennemis[enn].entite.y, e->ennemis[enn].entite.type);
-                        e->ennemis[enn].entite.vivant = 0;
-                        e->score += 10; /* ou 20 si sante était 2 ? */
-                    }
-                    break;
+        if (projs->proprietaire[i] == 0) {
+            /* projectile joueur : collision avec ennemis (la case du tir
+             * donne la ligne et la colonne de la formation, puis un bit est testé) */
+            int enn = formation_emplacement(f, px, py);
+            if (enn >= 0) {
+                projs->actif[i] = 0;
+                /* pas de décrément sous 1 : une santé de 0 venue d'une
+                 * sauvegarde ne déborde pas à 255 */
+                if (f->sante[enn] > 1) {
+                    f->sante[enn] -= 1;
+                } else {
+                    f->sante[enn] = 0;
+                    creer_explosion(e, px, py, f->type[enn]);
+                    formation_tuer(f, enn / f->colonnes, enn % f->colonnes);
+                    e->score += 10; /* ou 20 si sante était 2 ? */
+                    emettre(e, EVT_ENNEMI_TUE, px, py, f->type[enn], e->score);
                 }
             }
-            
+
             /* projectile joueur : collision avec boucliers */
-            for (int b = 0; b < e->nombre_boucliers; ++b) {
-                if (!e->boucliers[b].entite.vivant) continue;
-                if (e->boucliers[b].entite.x == e->projectiles[i].x && e->boucliers[b].entite.y == e->projectiles[i].y) {
-                    e->projectiles[i].actif = 0;
-                    e->boucliers[b].entite.sante -= 1;
-                    if (e->boucliers[b].entite.sante <= 0) {
-                        creer_explosion(e, e->boucliers[b].entite.x, e->boucliers[b].entite.y, e->boucliers[b].entite.type);
-                        e->boucliers[b].entite.vivant = 0;
-                    }
-                    break;
-                }
-            }
+            if (toucher_bouclier(e, px, py)) projs->actif[i] = 0;
         } else {
             /* projectile ennemi : collision avec vaisseau */
-            int y_vaisseau = ligne_vaisseau(e);
-            if (e->projectiles[i].x == e->joueur.entite.x && e->projectiles[i].y == y_vaisseau) {
-                e->projectiles[i].actif = 0;
+            if (px == e->joueur.entite.x && py == ligne_vaisseau(e)) {
+                projs->actif[i] = 0;
                 e->vies -= 1;
+                emettre(e, EVT_JOUEUR_TOUCHE, px, py, e->vies > 0 ? e->vies : 0, 0);
                 if (e->vies <= 0) e->game_over = 1;
             }
-            
+
             /* projectile ennemi : collision avec boucliers */
-            for (int b = 0; b < e->nombre_boucliers; ++b) {
-                if (!e->boucliers[b].entite.vivant) continue;
-                if (e->boucliers[b].entite.x == e->projectiles[i].x && e->boucliers[b].entite.y == e->projectiles[i].y) {
-                    e->projectiles[i].actif = 0;
-                    e->boucliers[b].entite.sante -= 1;
-                    if (e->boucliers[b].entite.sante <= 0) {
-                        creer_explosion(e, e->boucliers[b].entite.x, e->boucliers[b].entite.y, e->boucliers[b].entite.type);
-                        e->boucliers[b].entite.vivant = 0;
-                    }
-                    break;
-                }
-            }
+            if (toucher_bouclier(e, px, py)) projs->actif[i] = 0;
         }
+
+        if (projs->actif[i]) ++i;
+        else retirer_projectile(projs, i);
     }
+    projs->deplaces = projs->nombre; /* les tirs créés ensuite n'ont pas encore bougé */
 
-    /* Déplacement des ennemis selon un intervalle */
+    /* Déplacement des ennemis selon un intervalle : la formation entière
+     * avance d'une case en changeant son décalage */
     e->acc_deplacement_ennemis += dt;
-    int vivants = nombre_ennemis_vivants(e);
-    if (vivants == 0) {
+    if (f->vivants_total == 0) {
         /* niveau vidé : réapparition un peu plus rapide et augmenter la difficulté */
         e->niveau += 1;
         e->intervalle_deplacement_ennemis *= 0.9; /* accélère un peu */
-        
-        int lignes = 3;
-        int colonnes = 8;
-        int start_y = 2;
-        int espacement_x = (e->largeur - 4) / colonnes;
-        if (espacement_x < 2) espacement_x = 2;
-        e->nombre_ennemis = 0;
-        for (int r = 0; r < lignes; ++r) {
-            for (int c = 0; c < colonnes; ++c) {
-                int idx = e->nombre_ennemis++;
-                if (idx >= NB_MAX_ENNEMIS) break;
-                e->ennemis[idx].entite.vivant = 1;
-                e->ennemis[idx].entite.x = 2 + c * espacement_x;
-                e->ennemis[idx].entite.y = start_y + r*2;
-                e->ennemis[idx].entite.dmg = 1;
-                /* Santé basée sur le niveau */
-                e->ennemis[idx].entite.sante = 1;
-                if (e->niveau >= 2) {
-                    int pourcentage = 25 + (e->niveau - 2) * 15;
-                    if (rand() % 100 < pourcentage) e->ennemis[idx].entite.sante = 2;
-                }
-            }
-        }
+
+        generer_vague(e);
+        emettre(e, EVT_VAGUE_TERMINEE, 0, 0, 0, e->niveau);
     }
 
     if (e->acc_deplacement_ennemis >= e->intervalle_deplacement_ennemis) {
         e->acc_deplacement_ennemis = 0.0;
-        /* tentative de déplacement horizontal */
-        int touche_bord = 0;
-        for (int i = 0; i < e->nombre_ennemis; ++i) {
-            if (!e->ennemis[i].entite.vivant) continue;
-            int nx = e->ennemis[i].entite.x + e->direction_ennemis;
-            if (nx < 0 || nx >= e->largeur) { touche_bord = 1; break; }
-        }
+        /* tentative de déplacement horizontal : seules les colonnes extrêmes comptent */
+        int touche_bord = f->vivants_total > 0 &&
+            (formation_x(f, f->colonne_min) + e->direction_ennemis < 0 ||
+             formation_x(f, f->colonne_max) + e->direction_ennemis >= e->largeur);
         if (touche_bord) {
             /* change de direction et descend */
             e->direction_ennemis = -e->direction_ennemis;
-            for (int i = 0; i < e->nombre_ennemis; ++i) if (e->ennemis[i].entite.vivant) e->ennemis[i].entite.y += 1;
+            f->decalage_y += 1;
+            e->marche_dy = 1;
         } else {
-            for (int i = 0; i < e->nombre_ennemis; ++i) if (e->ennemis[i].entite.vivant) e->ennemis[i].entite.x += e->direction_ennemis;
+            f->decalage_x += e->direction_ennemis;
+            e->marche_dx = e->direction_ennemis;
         }
     }
 
-    /* Tir ennemi : petite probabilité aléatoire */
-    if (rand() % 100 < 4) { /* ~4% par tick */
-        int idxs[NB_MAX_ENNEMIS]; int n = 0;
-        for (int i = 0; i < e->nombre_ennemis; ++i) if (e->ennemis[i].entite.vivant) idxs[n++] = i;
-        if (n > 0) {
-            int pick = idxs[rand() % n];
-            ajouter_projectile(e, e->ennemis[pick].entite.x, e->ennemis[pick].entite.y + 1, +1, 1);
+    /* Tir ennemi : petite probabilité aléatoire. Le tireur est toujours le
+     * vivant le plus bas d'une colonne ; la colonne dépend de la politique
+     * de la vague. */
+    if (f->rafale_restante > 0 && --f->rafale_attente <= 0) {
+        if (f->tireur[f->rafale_colonne] >= 0) {
+            formation_tirer(e, f->rafale_colonne);
+            f->rafale_restante -= 1;
+            f->rafale_attente = RAFALE_INTERVALLE;
+        } else {
+            f->rafale_restante = 0; /* colonne détruite pendant la rafale */
+        }
+    }
+    if (alea_borne(e, 100) < 4 && f->nb_colonnes_tir > 0) { /* ~4% par tick */
+        if (f->politique == TIR_VISE) {
+            formation_tirer(e, formation_colonne_proche(f, e->joueur.entite.x));
+        } else {
+            int c = f->colonnes_tir[alea_borne(e, f->nb_colonnes_tir)];
+            if (f->politique != TIR_RAFALE) {
+                formation_tirer(e, c);
+            } else if (f->rafale_restante == 0) {
+                formation_tirer(e, c);
+                f->rafale_colonne = c;
+                f->rafale_restante = RAFALE_TIRS - 1;
+                f->rafale_attente = RAFALE_INTERVALLE;
+            }
         }
     }
 
     /* Défaite immédiate si un ennemi atteint la ligne du vaisseau */
-    int ligne_joueur = ligne_vaisseau(e);
-    for (int i = 0; i < e->nombre_ennemis; ++i) {
-        if (!e->ennemis[i].entite.vivant) continue;
-        if (e->ennemis[i].entite.y >= ligne_joueur) {
-            e->game_over = 1;
-            e->vies = 0;
-            break;
-        }
+    if (f->vivants_total > 0 && formation_y(f, f->ligne_max) >= ligne_vaisseau(e)) {
+        e->game_over = 1;
+        e->vies = 0;
+    }
+    if (e->game_over && !etait_game_over) emettre(e, EVT_GAME_OVER, 0, 0, 0, e->score);
+    e->tick += 1;
+}
+
+void etatjeu_tick(EtatJeu* e) {
+    etatjeu_mettre_a_jour(e, PAS_FIXE);
+}
+
+int etatjeu_avancer(EtatJeu* e, double dt_reel) {
+    return etatjeu_avancer_avec(e, dt_reel, NULL, NULL);
+}
+
+int etatjeu_avancer_avec(EtatJeu* e, double dt_reel, AvantTick avant_tick, void* contexte) {
+    if (!e || dt_reel <= 0.0) return 0;
+    e->acc_pas += dt_reel;
+    int ticks = 0;
+    while (e->acc_pas >= PAS_FIXE && ticks < TICKS_MAX_PAR_IMAGE && !e->game_over) {
+        if (avant_tick) avant_tick(e, contexte);
+        etatjeu_tick(e);
+        e->acc_pas -= PAS_FIXE;
+        ++ticks;
     }
+    /* retard impossible à rattraper (machine trop lente, fenêtre bloquée) ou
+     * partie terminée : le temps restant est abandonné, sinon chaque image
+     * suivante hériterait de la dette et enchaînerait le maximum de ticks */
+    if (e->acc_pas >= PAS_FIXE || e->game_over) e->acc_pas = 0.0;
+    return ticks;
+}
+
+double etatjeu_alpha(const EtatJeu* e) {
+    return e ? e->acc_pas / PAS_FIXE : 0.0;
 }
 
 void etatjeu_deplacer_vaisseau(EtatJeu* e, int dir) {
@@ -390,53 +822,25 @@ void etatjeu_vaisseau_tirer(EtatJeu* e) {
 
 int etatjeu_obtenir_vaisseau_x(const EtatJeu* e) { return e ? e->joueur.entite.x : 0; }
 int etatjeu_obtenir_largeur(const EtatJeu* e) { return e ? e->largeur : 0; }
+int etatjeu_obtenir_hauteur(const EtatJeu* e) { return e ? e->hauteur : 0; }
+void etatjeu_obtenir_config(const EtatJeu* e, ConfigJeu* c) { if (e && c) *c = e->config; }
 int etatjeu_obtenir_vies(const EtatJeu* e) { return e ? e->vies : 0; }
 int etatjeu_obtenir_score(const EtatJeu* e) { return e ? e->score : 0; }
 int etatjeu_devrait_quitter(const EtatJeu* e) { return e ? e->quitter : 1; }
+uint64_t etatjeu_obtenir_tick(const EtatJeu* e) { return e ? e->tick : 0; }
+uint64_t etatjeu_obtenir_graine(const EtatJeu* e) { return e ? e->graine : 0; }
 
 /* API ennemis / projectiles (getters en lecture seule pour les vues) */
-int etatjeu_obtenir_nombre_ennemis(const EtatJeu* e) { return e ? e->nombre_ennemis : 0; }
-int etatjeu_obtenir_ennemi_x(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->nombre_ennemis) ? e->ennemis[idx].entite.x : 0; }
-int etatjeu_obtenir_ennemi_y(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->nombre_ennemis) ? e->ennemis[idx].entite.y : 0; }
-int etatjeu_ennemi_vivant(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->nombre_ennemis) ? e->ennemis[idx].entite.vivant : 0; }
-int etatjeu_obtenir_ennemi_sante(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->nombre_ennemis) ? e->ennemis[idx].entite.sante : 0; }
+int etatjeu_obtenir_nombre_ennemis(const EtatJeu* e) { return e ? e->formation.nombre : 0; }
+int etatjeu_obtenir_ennemi_x(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->formation.nombre) ? formation_x(&e->formation, idx % e->formation.colonnes) : 0; }
+int etatjeu_obtenir_ennemi_y(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->formation.nombre) ? formation_y(&e->formation, idx / e->formation.colonnes) : 0; }
+int etatjeu_ennemi_vivant(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->formation.nombre) ? formation_vivant(&e->formation, idx / e->formation.colonnes, idx % e->formation.colonnes) : 0; }
+int etatjeu_obtenir_ennemi_sante(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->formation.nombre) ? e->formation.sante[idx] : 0; }
 
-int etatjeu_obtenir_nombre_projectiles(const EtatJeu* e) {
-    if (!e) return 0;
-    int c = 0;
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) if (e->projectiles[i].actif) ++c;
-    return c;
-}
-
-int etatjeu_obtenir_projectile_x(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) {
-        if (!e->projectiles[i].actif) continue;
-        if (seen++ == idx) return e->projectiles[i].x;
-    }
-    return 0;
-}
-
-int etatjeu_obtenir_projectile_y(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) {
-        if (!e->projectiles[i].actif) continue;
-        if (seen++ == idx) return e->projectiles[i].y;
-    }
-    return 0;
-}
-
-int etatjeu_obtenir_projectile_proprietaire(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) {
-        if (!e->projectiles[i].actif) continue;
-        if (seen++ == idx) return e->projectiles[i].proprietaire;
-    }
-    return 0;
-}
+int etatjeu_obtenir_nombre_projectiles(const EtatJeu* e) { return e ? e->projectiles.nombre : 0; }
+int etatjeu_obtenir_projectile_x(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->projectiles.nombre) ? e->projectiles.x[idx] : 0; }
+int etatjeu_obtenir_projectile_y(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->projectiles.nombre) ? e->projectiles.y[idx] : 0; }
+int etatjeu_obtenir_projectile_proprietaire(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->projectiles.nombre) ? e->projectiles.proprietaire[idx] : 0; }
 
 /* API boucliers */
 int etatjeu_obtenir_nombre_boucliers(const EtatJeu* e) { return e ? e->nombre_boucliers : 0; }
@@ -450,112 +854,663 @@ int etatjeu_obtenir_niveau(const EtatJeu* e) { return e ? e->niveau : 1; }
 /* Accesseur pour game over */
 int etatjeu_est_game_over(const EtatJeu* e) { return e ? e->game_over : 0; }
 
-/* Réinitialise le jeu (recommencer) */
-void etatjeu_reinitialiser(EtatJeu* e) {
-    if (!e) return;
-    e->joueur.entite.x = e->largeur / 2;
-    e->joueur.entite.y = e->hauteur - 1;
-    e->joueur.entite.vivant = 1;
-    e->joueur.entite.sante = 1;
-    e->joueur.entite.dmg = 1;
-    e->vies = 3;
-    e->score = 0;
-    e->niveau = 1;
-    e->temps_acc = 0.0;
-    e->quitter = 0;
-    e->game_over = 0;
-    
-    /* réinitialiser les ennemis */
-    e->nombre_ennemis = 0;
-    e->direction_ennemis = 1;
-    e->acc_deplacement_ennemis = 0.0;
-    e->intervalle_deplacement_ennemis = 0.6;
-    int lignes = 3;
-    int colonnes = 8;
-    int start_y = 2;
-    int espacement_x = (e->largeur - 4) / colonnes;
-    if (espacement_x < 2) espacement_x = 2;
-    for (int r = 0; r < lignes; ++r) {
-        for (int c = 0; c < colonnes; ++c) {
-            int idx = e->nombre_ennemis++;
-            if (idx >= NB_MAX_ENNEMIS) break;
-            e->ennemis[idx].entite.vivant = 1;
-            e->ennemis[idx].entite.x = 2 + c * espacement_x;
-            e->ennemis[idx].entite.y = start_y + r*2;
-            e->ennemis[idx].entite.dmg = 1;
-        }
+void etatjeu_evenements_suivre(const EtatJeu* e, CurseurEvenements* c) {
+    if (!c) return;
+    c->position = e ? e->evenements_ecrits : 0;
+    c->perdus = 0;
+}
+
+int etatjeu_evenements_lire(const EtatJeu* e, CurseurEvenements* c, Evenement* dst, int max) {
+    if (!e || !c || !dst || max <= 0) return 0;
+    if (c->position > e->evenements_ecrits) c->position = e->evenements_ecrits; /* curseur d'une autre partie */
+    /* curseur dépassé : les événements écrasés sont comptés comme perdus */
+    if (e->evenements_ecrits - c->position > EVENEMENTS_CAPACITE) {
+        uint64_t plus_ancien = e->evenements_ecrits - EVENEMENTS_CAPACITE;
+        c->perdus += plus_ancien - c->position;
+        c->position = plus_ancien;
     }
-    
-    /* réinitialiser projectiles */
-    for (int i = 0; i < NB_MAX_PROJECTILES; ++i) e->projectiles[i].actif = 0;
-    e->nombre_projectiles = 0;
-    
-    /* réinitialiser boucliers */
-    int espacement_boucliers = e->largeur / 5;
-    for (int i = 0; i < NB_MAX_BOUCLIERS; ++i) {
-        e->boucliers[i].entite.vivant = 1;
-        e->boucliers[i].entite.x = espacement_boucliers * (i + 1);
-        e->boucliers[i].entite.y = e->hauteur / 2;
-        e->boucliers[i].entite.sante = 3;
-        e->boucliers[i].entite.dmg = 0;
-        e->boucliers[i].entite.type = TYPE_BOUCLIER;
+    int n = 0;
+    while (n < max && c->position < e->evenements_ecrits) {
+        dst[n++] = e->evenements[c->position & (EVENEMENTS_CAPACITE - 1)];
+        c->position += 1;
     }
-    
-    /* réinitialiser particules */
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) e->particules[i].ttl = 0;
-    e->nombre_particules = 0;
+    return n;
+}
+
+/* Réinitialise le jeu (recommencer). La graine de la nouvelle partie est
+ * tirée du générateur en cours : chaque partie diffère de la précédente,
+ * mais la suite des parties reste fixée par la graine de départ. */
+void etatjeu_reinitialiser(EtatJeu* e) {
+    if (!e) return;
+    e->graine = melanger_graine(e->alea);
+    initialiser_partie(e);
 }
 
 /* Aide interne pour le contrôleur : définit le drapeau quitter */
 void _etatjeu_definir_quitter(EtatJeu* e, int q) { if (e) e->quitter = q; }
 /* API Particules */
-int etatjeu_obtenir_nombre_particules(const EtatJeu* e) {
-    if (!e) return 0;
-    int c = 0;
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) if (e->particules[i].ttl > 0) ++c;
-    return c;
-}
+int etatjeu_obtenir_nombre_particules(const EtatJeu* e) { return e ? e->particules.nombre : 0; }
+int etatjeu_obtenir_particule_x(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->particules.nombre) ? e->particules.x[idx] : 0; }
+int etatjeu_obtenir_particule_y(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->particules.nombre) ? e->particules.y[idx] : 0; }
+int etatjeu_obtenir_particule_type(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->particules.nombre) ? e->particules.type[idx] : 0; }
+int etatjeu_obtenir_particule_ttl(const EtatJeu* e, int idx) { return (e && idx >= 0 && idx < e->particules.nombre) ? e->particules.ttl[idx] : 0; }
 
-int etatjeu_obtenir_particule_x(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) {
-        if (e->particules[i].ttl <= 0) continue;
-        if (seen == idx) return e->particules[i].x;
-        ++seen;
+/* Capture pour le rendu */
+int etatjeu_capture_allouer(RenderSnapshot* s, const EtatJeu* e) {
+    if (!s || !e) return 1;
+    memset(s, 0, sizeof(*s));
+    s->ennemis = (EntiteRendu*)malloc(sizeof(EntiteRendu) * (size_t)e->formation.capacite);
+    s->projectiles = (EntiteRendu*)malloc(sizeof(EntiteRendu) * (size_t)e->projectiles.capacite);
+    s->boucliers = (EntiteRendu*)malloc(sizeof(EntiteRendu) * NB_MAX_BOUCLIERS);
+    s->particules = (EntiteRendu*)malloc(sizeof(EntiteRendu) * (size_t)e->particules.capacite);
+    if (!s->ennemis || !s->projectiles || !s->boucliers || !s->particules) {
+        etatjeu_capture_liberer(s);
+        return 1;
     }
+    s->cap_ennemis = e->formation.capacite;
+    s->cap_projectiles = e->projectiles.capacite;
+    s->cap_boucliers = NB_MAX_BOUCLIERS;
+    s->cap_particules = e->particules.capacite;
     return 0;
 }
 
-int etatjeu_obtenir_particule_y(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) {
-        if (e->particules[i].ttl <= 0) continue;
-        if (seen == idx) return e->particules[i].y;
-        ++seen;
+void etatjeu_capture_liberer(RenderSnapshot* s) {
+    if (!s) return;
+    free(s->ennemis);
+    free(s->projectiles);
+    free(s->boucliers);
+    free(s->particules);
+    memset(s, 0, sizeof(*s));
+}
+
+void etatjeu_capturer(const EtatJeu* e, RenderSnapshot* s) {
+    if (!e || !s) return;
+    s->largeur = e->largeur;
+    s->hauteur = e->hauteur;
+    s->vaisseau_x = e->joueur.entite.x;
+    s->vaisseau_y = ligne_vaisseau(e);
+    s->vies = e->vies;
+    s->score = e->score;
+    s->niveau = e->niveau;
+    s->game_over = e->game_over;
+    s->alpha = etatjeu_alpha(e);
+
+    /* ennemis : les bits à 1 du masque de vie, ligne par ligne */
+    int n = 0;
+    const Formation* f = &e->formation;
+    for (int l = 0; l < f->lignes && n < s->cap_ennemis; ++l) {
+        if (f->vivants_ligne[l] <= 0) continue;
+        int16_t y = (int16_t)formation_y(f, l);
+        for (int m = 0; m < f->mots_par_ligne; ++m) {
+            uint64_t mot = f->vivants[(size_t)l * (size_t)f->mots_par_ligne + (size_t)m];
+            for (; mot && n < s->cap_ennemis; mot &= mot - 1) {
+                int c = m * 64 + mot_premier_bit(mot);
+                int i = l * f->colonnes + c;
+                EntiteRendu* r = &s->ennemis[n++];
+                r->x = (int16_t)formation_x(f, c);
+                r->y = y;
+                r->type = f->type[i];
+                r->valeur = f->sante[i];
+                r->dx = (int8_t)e->marche_dx;
+                r->dy = (int8_t)e->marche_dy;
+            }
+        }
+    }
+    s->nb_ennemis = n;
+
+    /* projectiles et particules sont denses : une copie directe suffit */
+    const Projectiles* projs = &e->projectiles;
+    n = projs->nombre < s->cap_projectiles ? projs->nombre : s->cap_projectiles;
+    for (int i = 0; i < n; ++i) {
+        EntiteRendu* r = &s->projectiles[i];
+        r->x = projs->x[i];
+        r->y = projs->y[i];
+        r->type = projs->proprietaire[i];
+        r->valeur = 0;
+        r->dx = 0;
+        r->dy = (int8_t)(i < projs->deplaces ? projs->dy[i] : 0);
+    }
+    s->nb_projectiles = n;
+
+    n = 0;
+    for (int i = 0; i < e->nombre_boucliers && n < s->cap_boucliers; ++i) {
+        const Entite* b = &e->boucliers[i].entite;
+        if (!b->vivant) continue;
+        EntiteRendu* r = &s->boucliers[n++];
+        r->x = (int16_t)b->x;
+        r->y = (int16_t)b->y;
+        r->type = (uint8_t)b->type;
+        r->valeur = (uint8_t)b->sante;
+        r->dx = 0;
+        r->dy = 0;
+    }
+    s->nb_boucliers = n;
+
+    const Particules* parts = &e->particules;
+    n = parts->nombre < s->cap_particules ? parts->nombre : s->cap_particules;
+    for (int i = 0; i < n; ++i) {
+        EntiteRendu* r = &s->particules[i];
+        r->x = parts->x[i];
+        r->y = parts->y[i];
+        r->type = parts->type[i];
+        r->valeur = (uint8_t)parts->ttl[i];
+        r->dx = (int8_t)(i < parts->deplaces ? parts->vx[i] : 0);
+        r->dy = (int8_t)(i < parts->deplaces ? parts->vy[i] : 0);
     }
+    s->nb_particules = n;
+}
+
+/*
+ * Calque de rendu. Une actualisation passe trois fois sur les cases :
+ *   1. les cases occupées avant l'appel sont vidées et marquées (bit
+ *      CALQUE_MARQUE), leur ancien code mis de côté ;
+ *   2. les entités sont posées dans l'ordre de dessin ; la première pose sur
+ *      une case l'ajoute à la nouvelle liste des cases occupées et, si la
+ *      case n'était pas marquée (elle était vide), la déclare modifiée ;
+ *   3. chaque ancienne case est comparée à son ancien code et démarquée.
+ * Rien d'autre n'est lu : le coût suit le nombre d'entités.
+ */
+#define CALQUE_MARQUE 0x80
+
+/* Alloue le calque et ses listes (une case occupée au plus par entité) */
+static int calque_allouer(EtatJeu* e) {
+    size_t cases = (size_t)e->largeur * (size_t)e->hauteur;
+    size_t entites = (size_t)e->formation.capacite + (size_t)e->projectiles.capacite +
+                     NB_MAX_BOUCLIERS + (size_t)e->particules.capacite + 1;
+    size_t taille = 0;
+    size_t o_c = reserver(&taille, cases);
+    size_t o_o = reserver(&taille, entites * sizeof(int32_t));
+    size_t o_n = reserver(&taille, entites * sizeof(int32_t));
+    size_t o_a = reserver(&taille, entites);
+    size_t o_g = reserver(&taille, grille_nombre_mots(e->largeur, e->hauteur) * sizeof(uint64_t));
+    size_t o_l = reserver(&taille, grille_nombre_mots(e->hauteur, 1) * sizeof(uint64_t));
+    unsigned char* bloc = (unsigned char*)calloc(1, taille);
+    if (!bloc) return 1;
+    e->calque_bloc = bloc;
+    e->calque = bloc + o_c;
+    e->calque_occupees = (int32_t*)(bloc + o_o);
+    e->calque_nouvelles = (int32_t*)(bloc + o_n);
+    e->calque_anciens = bloc + o_a;
+    e->nb_occupees = 0;
+    e->nb_nouvelles = 0;
+    grille_lier(&e->grille_modifiee, (uint64_t*)(bloc + o_g), e->largeur, e->hauteur);
+    e->lignes_modifiees = (uint64_t*)(bloc + o_l);
+    e->cases_modifiees = 0;
     return 0;
 }
 
-int etatjeu_obtenir_particule_type(const EtatJeu* e, int idx) {
-    if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) {
-        if (e->particules[i].ttl <= 0) continue;
-        if (seen == idx) return e->particules[i].type;
-        ++seen;
+static void calque_marquer(EtatJeu* e, int x, int y) {
+    uint64_t* mot = grille_mot(&e->grille_modifiee, x, y);
+    uint64_t bit = (uint64_t)1 << (x & 63);
+    if (*mot & bit) return;
+    *mot |= bit;
+    e->lignes_modifiees[y >> 6] |= (uint64_t)1 << (y & 63);
+    e->cases_modifiees += 1;
+}
+
+/* Pose `code` en (x, y) ; les entités hors du terrain ne sont pas dessinées */
+static void calque_poser(EtatJeu* e, int x, int y, uint8_t code) {
+    if (x < 0 || x >= e->largeur || y < 0 || y >= e->hauteur) return;
+    int32_t i = (int32_t)y * e->largeur + x;
+    uint8_t ancien = e->calque[i];
+    if ((ancien & ~CALQUE_MARQUE) == CASE_VIDE) {
+        e->calque_nouvelles[e->nb_nouvelles++] = i;
+        if (!(ancien & CALQUE_MARQUE)) calque_marquer(e, x, y);
+    }
+    e->calque[i] = (uint8_t)(code | (ancien & CALQUE_MARQUE));
+}
+
+long etatjeu_calque_actualiser(EtatJeu* e) {
+    if (!e) return -1;
+    if (!e->calque_bloc && calque_allouer(e) != 0) return -1;
+
+    for (int k = 0; k < e->nb_occupees; ++k) {
+        int32_t i = e->calque_occupees[k];
+        e->calque_anciens[k] = e->calque[i];
+        e->calque[i] = CALQUE_MARQUE;
+    }
+
+    /* même ordre de dessin que les vues : ennemis, tirs, boucliers, particules, vaisseau */
+    e->nb_nouvelles = 0;
+    const Formation* f = &e->formation;
+    for (int l = 0; l < f->lignes; ++l) {
+        if (f->vivants_ligne[l] <= 0) continue;
+        int y = formation_y(f, l);
+        const uint8_t* sante = f->sante + (size_t)l * (size_t)f->colonnes;
+        for (int m = 0; m < f->mots_par_ligne; ++m) {
+            for (uint64_t mot = f->vivants[(size_t)l * (size_t)f->mots_par_ligne + (size_t)m]; mot; mot &= mot - 1) {
+                int c = m * 64 + mot_premier_bit(mot);
+                calque_poser(e, formation_x(f, c), y, sante[c] >= 2 ? CASE_ENNEMI_FORT : CASE_ENNEMI);
+            }
+        }
+    }
+    const Projectiles* projs = &e->projectiles;
+    for (int i = 0; i < projs->nombre; ++i)
+        calque_poser(e, projs->x[i], projs->y[i], projs->proprietaire[i] == 0 ? CASE_TIR_JOUEUR : CASE_TIR_ENNEMI);
+    for (int b = 0; b < e->nombre_boucliers; ++b) {
+        const Entite* bouclier = &e->boucliers[b].entite;
+        if (bouclier->vivant) calque_poser(e, bouclier->x, bouclier->y, CASE_BOUCLIER);
+    }
+    const Particules* parts = &e->particules;
+    for (int i = 0; i < parts->nombre; ++i) calque_poser(e, parts->x[i], parts->y[i], CASE_PARTICULE);
+    calque_poser(e, e->joueur.entite.x, ligne_vaisseau(e), CASE_VAISSEAU);
+
+    for (int k = 0; k < e->nb_occupees; ++k) {
+        int32_t i = e->calque_occupees[k];
+        uint8_t code = (uint8_t)(e->calque[i] & ~CALQUE_MARQUE);
+        e->calque[i] = code;
+        if (code != e->calque_anciens[k]) calque_marquer(e, i % e->largeur, i / e->largeur);
     }
+
+    int32_t* occupees = e->calque_occupees;
+    e->calque_occupees = e->calque_nouvelles;
+    e->calque_nouvelles = occupees;
+    e->nb_occupees = e->nb_nouvelles;
+    e->nb_nouvelles = 0;
+    return e->cases_modifiees;
+}
+
+const uint8_t* etatjeu_calque(const EtatJeu* e) {
+    return e ? e->calque : NULL;
+}
+
+int etatjeu_plage_suivante(const EtatJeu* e, CurseurPlages* c, PlageModifiee* p) {
+    if (!e || !c || !p || !e->calque_bloc) return 0;
+    const Grille* g = &e->grille_modifiee;
+    int mots_lignes = (e->hauteur + 63) / 64;
+    int y = c->y, x = c->x;
+    while (y < e->hauteur) {
+        /* prochaine ligne modifiée à partir de y */
+        int w = y >> 6;
+        uint64_t lignes = e->lignes_modifiees[w] & (~(uint64_t)0 << (y & 63));
+        while (!lignes && ++w < mots_lignes) lignes = e->lignes_modifiees[w];
+        if (!lignes) break;
+        int y_suivante = w * 64 + mot_premier_bit(lignes);
+        if (y_suivante != y) x = 0;
+        y = y_suivante;
+
+        /* premier bit à 1 à partir de x, puis premier bit à 0 après lui */
+        const uint64_t* ligne = g->mots + (size_t)y * (size_t)g->mots_par_ligne;
+        int m = x >> 6;
+        uint64_t mot = m < g->mots_par_ligne ? ligne[m] & (~(uint64_t)0 << (x & 63)) : 0;
+        while (!mot && ++m < g->mots_par_ligne) mot = ligne[m];
+        if (mot) {
+            int x0 = m * 64 + mot_premier_bit(mot);
+            uint64_t libres = ~ligne[m] & (~(uint64_t)0 << (x0 & 63));
+            while (!libres && ++m < g->mots_par_ligne) libres = ~ligne[m];
+            int x1 = libres ? m * 64 + mot_premier_bit(libres) : g->mots_par_ligne * 64;
+            if (x1 > e->largeur) x1 = e->largeur;
+            p->y = y;
+            p->x0 = x0;
+            p->x1 = x1;
+            c->y = y;
+            c->x = x1;
+            return 1;
+        }
+        ++y;
+        x = 0;
+    }
+    c->y = e->hauteur;
+    c->x = 0;
     return 0;
 }
 
-int etatjeu_obtenir_particule_ttl(const EtatJeu* e, int idx) {
+void etatjeu_calque_acquitter(EtatJeu* e) {
+    if (!e || !e->calque_bloc) return;
+    Grille* g = &e->grille_modifiee;
+    int mots_lignes = (e->hauteur + 63) / 64;
+    for (int w = 0; w < mots_lignes; ++w) {
+        for (uint64_t lignes = e->lignes_modifiees[w]; lignes; lignes &= lignes - 1) {
+            int y = w * 64 + mot_premier_bit(lignes);
+            grille_vider_lignes(g, y, y);
+        }
+        e->lignes_modifiees[w] = 0;
+    }
+    e->cases_modifiees = 0;
+}
+
+/*
+ * Sauvegarde binaire de l'état complet, au format natif de la machine
+ * (boutisme et représentation des doubles) :
+ *
+ *   EnteteSauvegarde | ScalairesSauvegarde | formation | projectiles | particules
+ *
+ * La formation est écrite telle quelle : masque de vie, tireurs et liste des
+ * colonnes de tir, comptes par ligne, puis santé et type des emplacements ; sa taille ne dépend
+ * que de la configuration. Des projectiles et des particules, seuls les
+ * `nombre` premiers éléments sont écrits, champ par champ. La restauration
+ * n'est qu'une suite de copies, sans refaire la vague. Les boucliers ont des
+ * cases fixes, seuls leur état et leur santé sont écrits. Le drapeau
+ * `quitter` (fin de session) et le temps réel en attente dans
+ * `etatjeu_avancer` appartiennent à la vue, pas à la partie : ils ne sont
+ * pas sauvegardés et repartent de zéro.
+ */
+typedef struct {
+    uint32_t magic;         /* SAUVEGARDE_MAGIC ; lu inversé sur une machine de boutisme différent */
+    uint16_t version;
+    uint16_t taille_entete;
+    uint32_t taille;        /* taille totale du blob */
+    int32_t largeur, hauteur, vague_lignes, vague_colonnes;
+    int32_t max_ennemis, max_projectiles, max_particules, politique_tir;
+} EnteteSauvegarde;
+
+typedef struct {
+    uint64_t graine, alea, tick;
+    double temps_acc, acc_deplacement_ennemis, intervalle_deplacement_ennemis;
+    int32_t vaisseau_x, vies, score, niveau, game_over;
+    int32_t direction_ennemis, decalage_x, decalage_y, marche_dx, marche_dy;
+    int32_t vivants, colonne_min, colonne_max, ligne_max, colonnes_tir;
+    int32_t politique, rafale_colonne, rafale_restante, rafale_attente;
+    int32_t nb_projectiles, projectiles_deplaces, nb_particules, particules_deplaces;
+    uint8_t bouclier_vivant[NB_MAX_BOUCLIERS];
+    int8_t bouclier_sante[NB_MAX_BOUCLIERS];
+} ScalairesSauvegarde;
+
+/* Octets par élément : x, y, dy, proprietaire / x, y, vx, vy, ttl, type */
+#define OCTETS_PROJECTILE (3 * sizeof(int16_t) + 1)
+#define OCTETS_PARTICULE (5 * sizeof(int16_t) + 1)
+
+static size_t taille_sauvegarde(const ConfigJeu* c, int projectiles, int particules) {
+    return sizeof(EnteteSauvegarde) + sizeof(ScalairesSauvegarde) + taille_formation(c) +
+           (size_t)projectiles * OCTETS_PROJECTILE +
+           (size_t)particules * OCTETS_PARTICULE;
+}
+
+static unsigned char* ecrire(unsigned char* p, const void* src, size_t n) {
+    memcpy(p, src, n);
+    return p + n;
+}
+
+static const unsigned char* lire(const unsigned char* p, void* dst, size_t n) {
+    memcpy(dst, p, n);
+    return p + n;
+}
+
+size_t etatjeu_sauvegarde_taille_max(const EtatJeu* e) {
     if (!e) return 0;
-    int seen = 0;
-    for (int i = 0; i < NB_MAX_PARTICULES; ++i) {
-        if (e->particules[i].ttl <= 0) continue;
-        if (seen == idx) return e->particules[i].ttl;
-        ++seen;
+    return taille_sauvegarde(&e->config, e->projectiles.capacite, e->particules.capacite);
+}
+
+size_t etatjeu_sauver(const EtatJeu* e, void* buf, size_t capacite) {
+    if (!e || !buf) return 0;
+    const Formation* f = &e->formation;
+    const Projectiles* projs = &e->projectiles;
+    const Particules* parts = &e->particules;
+    size_t taille = taille_sauvegarde(&e->config, projs->nombre, parts->nombre);
+    if (capacite < taille) return 0;
+
+    EnteteSauvegarde h;
+    memset(&h, 0, sizeof(h));
+    h.magic = SAUVEGARDE_MAGIC;
+    h.version = SAUVEGARDE_VERSION;
+    h.taille_entete = (uint16_t)sizeof(h);
+    h.taille = (uint32_t)taille;
+    h.largeur = e->config.largeur;
+    h.hauteur = e->config.hauteur;
+    h.vague_lignes = e->config.vague_lignes;
+    h.vague_colonnes = e->config.vague_colonnes;
+    h.max_ennemis = e->config.max_ennemis;
+    h.max_projectiles = e->config.max_projectiles;
+    h.max_particules = e->config.max_particules;
+    h.politique_tir = e->config.politique_tir;
+
+    /* mis à zéro d'abord : le remplissage du compilateur ne dépend pas de la pile */
+    ScalairesSauvegarde s;
+    memset(&s, 0, sizeof(s));
+    s.graine = e->graine;
+    s.alea = e->alea;
+    s.tick = e->tick;
+    s.temps_acc = e->temps_acc;
+    s.acc_deplacement_ennemis = e->acc_deplacement_ennemis;
+    s.intervalle_deplacement_ennemis = e->intervalle_deplacement_ennemis;
+    s.vaisseau_x = e->joueur.entite.x;
+    s.vies = e->vies;
+    s.score = e->score;
+    s.niveau = e->niveau;
+    s.game_over = e->game_over;
+    s.direction_ennemis = e->direction_ennemis;
+    s.decalage_x = f->decalage_x;
+    s.decalage_y = f->decalage_y;
+    s.marche_dx = e->marche_dx;
+    s.marche_dy = e->marche_dy;
+    s.vivants = f->vivants_total;
+    s.colonne_min = f->colonne_min;
+    s.colonne_max = f->colonne_max;
+    s.ligne_max = f->ligne_max;
+    s.colonnes_tir = f->nb_colonnes_tir;
+    s.politique = f->politique;
+    s.rafale_colonne = f->rafale_colonne;
+    s.rafale_restante = f->rafale_restante;
+    s.rafale_attente = f->rafale_attente;
+    s.nb_projectiles = projs->nombre;
+    s.projectiles_deplaces = projs->deplaces;
+    s.nb_particules = parts->nombre;
+    s.particules_deplaces = parts->deplaces;
+    for (int i = 0; i < NB_MAX_BOUCLIERS; ++i) {
+        s.bouclier_vivant[i] = (uint8_t)e->boucliers[i].entite.vivant;
+        s.bouclier_sante[i] = (int8_t)e->boucliers[i].entite.sante;
+    }
+
+    size_t np = (size_t)projs->nombre, nq = (size_t)parts->nombre;
+    unsigned char* p = (unsigned char*)buf;
+    p = ecrire(p, &h, sizeof(h));
+    p = ecrire(p, &s, sizeof(s));
+    p = ecrire(p, f->vivants, taille_formation(&e->config));
+    p = ecrire(p, projs->x, np * sizeof(int16_t));
+    p = ecrire(p, projs->y, np * sizeof(int16_t));
+    p = ecrire(p, projs->dy, np * sizeof(int16_t));
+    p = ecrire(p, projs->proprietaire, np);
+    p = ecrire(p, parts->x, nq * sizeof(int16_t));
+    p = ecrire(p, parts->y, nq * sizeof(int16_t));
+    p = ecrire(p, parts->vx, nq * sizeof(int16_t));
+    p = ecrire(p, parts->vy, nq * sizeof(int16_t));
+    p = ecrire(p, parts->ttl, nq * sizeof(int16_t));
+    p = ecrire(p, parts->type, nq);
+    return taille;
+}
+
+/* Lit et vérifie l'en-tête. La configuration lue n'est pas validée ici :
+ * etatjeu_restaurer l'exige égale à celle de l'état, allouer_etat la refuse
+ * si elle est invalide. @return taille du blob, 0 s'il est invalide */
+static size_t lire_entete(const void* buf, size_t taille, ConfigJeu* c) {
+    EnteteSauvegarde h;
+    if (!buf || taille < sizeof(h)) return 0;
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != SAUVEGARDE_MAGIC || h.version != SAUVEGARDE_VERSION ||
+        h.taille_entete != sizeof(h) || h.taille > taille) return 0;
+    c->largeur = h.largeur;
+    c->hauteur = h.hauteur;
+    c->vague_lignes = h.vague_lignes;
+    c->vague_colonnes = h.vague_colonnes;
+    c->max_ennemis = h.max_ennemis;
+    c->max_projectiles = h.max_projectiles;
+    c->max_particules = h.max_particules;
+    c->politique_tir = h.politique_tir;
+    return h.taille;
+}
+
+/* Vérifie la formation écrite en `p` : aucun bit hors des emplacements de
+ * la vague, chaque emplacement a une santé de 0 à 2 et un type connu,
+ * chaque tireur est vivant, la liste des colonnes de tir et leurs rangs se
+ * correspondent, et les comptes concordent avec le masque.
+ * @return 1 si elle est cohérente */
+static int formation_valide(const ConfigJeu* c, const ScalairesSauvegarde* s, const unsigned char* p) {
+    int lignes = c->vague_lignes, colonnes = c->vague_colonnes, mots = (colonnes + 63) / 64;
+    int nombre = ennemis_par_vague(c);
+    if (s->vivants < 0 || s->vivants > nombre ||
+        s->colonne_min < 0 || s->colonne_min > s->colonne_max || s->colonne_max >= colonnes ||
+        s->ligne_max < 0 || s->ligne_max >= lignes ||
+        s->colonnes_tir < 0 || s->colonnes_tir > colonnes || (s->colonnes_tir == 0) != (s->vivants == 0) ||
+        s->politique < TIR_ALEATOIRE || s->politique > TIR_RAFALE ||
+        s->rafale_colonne < 0 || s->rafale_colonne >= colonnes ||
+        s->rafale_restante < 0 || s->rafale_restante >= RAFALE_TIRS ||
+        s->rafale_attente < 0 || s->rafale_attente > RAFALE_INTERVALLE) return 0;
+    const unsigned char* masque = p;
+    const unsigned char* tireurs = masque + (size_t)lignes * (size_t)mots * sizeof(uint64_t);
+    const unsigned char* liste = tireurs + (size_t)colonnes * sizeof(int32_t);
+    const unsigned char* rangs = liste + (size_t)colonnes * sizeof(int32_t);
+    const unsigned char* sante = rangs + (size_t)(colonnes + lignes) * sizeof(int32_t);
+    const unsigned char* type = sante + (size_t)nombre;
+    /* chaque ligne compte autant de bits que son entrée de `vivants_ligne` */
+    const unsigned char* par_ligne = rangs + (size_t)colonnes * sizeof(int32_t);
+    long total = 0;
+    for (int r = 0; r < lignes; ++r) {
+        /* colonnes occupées de la ligne r (la dernière ligne peut être tronquée) */
+        long reste = (long)nombre - (long)r * colonnes;
+        int largeur = reste <= 0 ? 0 : (reste < colonnes ? (int)reste : colonnes);
+        int32_t vivants_ligne;
+        int bits_ligne = 0;
+        for (int m = 0; m < mots; ++m) {
+            uint64_t mot;
+            p = lire(p, &mot, sizeof(mot));
+            int bits = largeur - m * 64;
+            uint64_t permis = bits <= 0 ? 0 : (bits >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1);
+            if (mot & ~permis) return 0;
+            bits_ligne += mot_compter(mot);
+        }
+        memcpy(&vivants_ligne, par_ligne + (size_t)r * sizeof(vivants_ligne), sizeof(vivants_ligne));
+        if (vivants_ligne != bits_ligne) return 0;
+        total += bits_ligne;
+    }
+    if (total != s->vivants) return 0;
+    /* santé et type de chaque emplacement, vivant ou non, sans relire le
+     * masque : une santé au-delà de 2 ou un type inconnu refuse le blob */
+    if (noyau_octets_hors(sante, nombre, 0, 2) ||
+        noyau_octets_hors(type, nombre, TYPE_ENNEMI_FAIBLE, TYPE_ENNEMI_FORT)) return 0;
+    /* chaque colonne non vide a un rang dans la liste qui la désigne en
+     * retour : avec autant de colonnes non vides que d'entrées, la liste
+     * est exactement l'ensemble des colonnes non vides */
+    int non_vides = 0;
+    for (int col = 0; col < colonnes; ++col) {
+        int32_t t, rang, retour;
+        uint64_t mot;
+        memcpy(&t, tireurs + (size_t)col * sizeof(t), sizeof(t));
+        if (t < -1 || t >= lignes) return 0;
+        if (t < 0) continue;
+        memcpy(&mot, masque + ((size_t)t * (size_t)mots + (size_t)(col >> 6)) * sizeof(mot), sizeof(mot));
+        memcpy(&rang, rangs + (size_t)col * sizeof(rang), sizeof(rang));
+        if (!((mot >> (col & 63)) & 1u) || rang < 0 || rang >= s->colonnes_tir) return 0;
+        memcpy(&retour, liste + (size_t)rang * sizeof(retour), sizeof(retour));
+        if (retour != col) return 0;
+        ++non_vides;
+    }
+    if (non_vides != s->colonnes_tir) return 0;
+    if (s->vivants > 0) {
+        /* les colonnes extrêmes doivent être non vides */
+        int32_t t_min, t_max;
+        memcpy(&t_min, tireurs + (size_t)s->colonne_min * sizeof(t_min), sizeof(t_min));
+        memcpy(&t_max, tireurs + (size_t)s->colonne_max * sizeof(t_max), sizeof(t_max));
+        if (t_min < 0 || t_max < 0) return 0;
+    }
+    return 1;
+}
+
+int etatjeu_restaurer(EtatJeu* e, const void* buf, size_t taille) {
+    if (!e) return 1;
+    ConfigJeu c;
+    size_t taille_blob = lire_entete(buf, taille, &c);
+    if (taille_blob == 0 || memcmp(&c, &e->config, sizeof(c)) != 0) return 1;
+
+    /* tout est vérifié avant la première écriture : un blob refusé laisse `e` intact */
+    ScalairesSauvegarde s;
+    const unsigned char* p = (const unsigned char*)buf + sizeof(EnteteSauvegarde);
+    if (taille_blob < sizeof(EnteteSauvegarde) + sizeof(s)) return 1;
+    p = lire(p, &s, sizeof(s));
+    if (s.nb_projectiles < 0 || s.nb_projectiles > c.max_projectiles ||
+        s.projectiles_deplaces < 0 || s.projectiles_deplaces > s.nb_projectiles ||
+        s.nb_particules < 0 || s.nb_particules > c.max_particules ||
+        s.particules_deplaces < 0 || s.particules_deplaces > s.nb_particules ||
+        s.decalage_y < 0 || s.decalage_y >= c.hauteur ||
+        s.decalage_x <= -c.largeur || s.decalage_x >= c.largeur ||
+        taille_sauvegarde(&c, s.nb_projectiles, s.nb_particules) != taille_blob ||
+        s.vaisseau_x < 0 || s.vaisseau_x >= c.largeur ||
+        (s.direction_ennemis != 1 && s.direction_ennemis != -1) ||
+        s.marche_dx < -1 || s.marche_dx > 1 || s.marche_dy < 0 || s.marche_dy > 1 ||
+        !formation_valide(&c, &s, p)) return 1;
+
+    e->graine = s.graine;
+    e->alea = s.alea;
+    e->tick = s.tick;
+    e->temps_acc = s.temps_acc;
+    e->acc_pas = 0.0;
+    e->acc_deplacement_ennemis = s.acc_deplacement_ennemis;
+    e->intervalle_deplacement_ennemis = s.intervalle_deplacement_ennemis;
+    e->joueur.entite.x = s.vaisseau_x;
+    e->joueur.entite.y = e->hauteur - 1;
+    e->joueur.entite.vivant = 1;
+    e->joueur.entite.sante = 1;
+    e->joueur.entite.dmg = 1;
+    e->joueur.entite.type = TYPE_JOUEUR;
+    e->vies = s.vies;
+    e->score = s.score;
+    e->niveau = s.niveau;
+    e->game_over = s.game_over;
+    e->quitter = 0;
+    e->direction_ennemis = s.direction_ennemis;
+    e->marche_dx = s.marche_dx;
+    e->marche_dy = s.marche_dy;
+
+    Formation* f = &e->formation;
+    f->nombre = ennemis_par_vague(&c);
+    f->decalage_x = s.decalage_x;
+    f->decalage_y = s.decalage_y;
+    f->vivants_total = s.vivants;
+    f->colonne_min = s.colonne_min;
+    f->colonne_max = s.colonne_max;
+    f->ligne_max = s.ligne_max;
+    f->nb_colonnes_tir = s.colonnes_tir;
+    f->politique = s.politique;
+    f->rafale_colonne = s.rafale_colonne;
+    f->rafale_restante = s.rafale_restante;
+    f->rafale_attente = s.rafale_attente;
+    p = lire(p, f->vivants, taille_formation(&c));
+
+    Projectiles* projs = &e->projectiles;
+    size_t np = (size_t)s.nb_projectiles;
+    projs->nombre = s.nb_projectiles;
+    projs->deplaces = s.projectiles_deplaces;
+    p = lire(p, projs->x, np * sizeof(int16_t));
+    p = lire(p, projs->y, np * sizeof(int16_t));
+    p = lire(p, projs->dy, np * sizeof(int16_t));
+    p = lire(p, projs->proprietaire, np);
+    memset(projs->actif, MASQUE_VIVANT, np); /* entre deux ticks, tous les projectiles sont actifs */
+
+    Particules* parts = &e->particules;
+    size_t nq = (size_t)s.nb_particules;
+    parts->nombre = s.nb_particules;
+    parts->deplaces = s.particules_deplaces;
+    if (nq > 0) { /* les particules vivent quelques ticks : la réserve est le plus souvent vide */
+        p = lire(p, parts->x, nq * sizeof(int16_t));
+        p = lire(p, parts->y, nq * sizeof(int16_t));
+        p = lire(p, parts->vx, nq * sizeof(int16_t));
+        p = lire(p, parts->vy, nq * sizeof(int16_t));
+        p = lire(p, parts->ttl, nq * sizeof(int16_t));
+        p = lire(p, parts->type, nq);
+    }
+
+    /* les boucliers gardent leurs cases : seul le bit d'un bouclier qui
+     * change d'état est touché dans la grille */
+    for (int i = 0; i < NB_MAX_BOUCLIERS; ++i) {
+        Entite* b = &e->boucliers[i].entite;
+        int vivant = s.bouclier_vivant[i] != 0;
+        if (vivant != b->vivant) {
+            if (vivant) grille_poser(&e->grille_boucliers, b->x, b->y);
+            else grille_effacer(&e->grille_boucliers, b->x, b->y);
+        }
+        b->vivant = vivant;
+        b->sante = s.bouclier_sante[i];
     }
     return 0;
 }
+
+EtatJeu* etatjeu_creer_depuis_sauvegarde(const void* buf, size_t taille) {
+    ConfigJeu c;
+    if (lire_entete(buf, taille, &c) == 0) return NULL;
+    EtatJeu* e = allouer_etat(&c);
+    if (!e) return NULL;
+    if (etatjeu_restaurer(e, buf, taille) != 0) {
+        etatjeu_detruire(e);
+        return NULL;
+    }
+    return e;
+}
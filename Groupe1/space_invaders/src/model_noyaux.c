@@ -0,0 +1,203 @@
+/*
+ * model_noyaux.c
+ * --------------
+ * Noyaux vectorisés (AVX2 / SSE2) et leur repli scalaire pour la mise à
+ * jour des particules et des projectiles, et la vérification des octets
+ * d'une sauvegarde. Chaque fonction traite d'abord des blocs de 16 entités
+ * (32 octets en AVX2 pour la vérification), puis termine en scalaire ; la
+ * vérification, sans écriture, relit plutôt un dernier bloc chevauchant.
+ *
+ * Les masques de vie valent 0x00 ou 0xFF : étendus à 16 bits, ils donnent
+ * directement 0x0000 / 0xFFFF, utilisables avec un ET logique.
+ */
+
+#include "model_noyaux.h"
+
+#include <string.h>
+
+#if defined(MODEL_SCALAIRE)
+#define NOYAU_SCALAIRE 1
+#elif defined(__AVX2__)
+#define NOYAU_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define NOYAU_SSE2 1
+#include <emmintrin.h>
+#else
+#define NOYAU_SCALAIRE 1
+#endif
+
+const char* noyau_variante(void) {
+#if defined(NOYAU_AVX2)
+    return "avx2";
+#elif defined(NOYAU_SSE2)
+    return "sse2";
+#else
+    return "scalaire";
+#endif
+}
+
+#if defined(NOYAU_SSE2)
+/* 16 masques octets -> deux vecteurs de 8 masques 16 bits */
+static void etendre_masques(const uint8_t* m, __m128i* bas, __m128i* haut) {
+    __m128i octets = _mm_loadu_si128((const __m128i*)m);
+    *bas = _mm_unpacklo_epi8(octets, octets);
+    *haut = _mm_unpackhi_epi8(octets, octets);
+}
+#endif
+
+#if defined(NOYAU_AVX2)
+/* 16 masques octets -> un vecteur de 16 masques 16 bits (extension de signe) */
+static __m256i etendre_masques(const uint8_t* m) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)m));
+}
+#endif
+
+void noyau_avancer_particules(int16_t* x, int16_t* y, const int16_t* vx, const int16_t* vy,
+                              int16_t* ttl, int n) {
+    int i = 0;
+#if defined(NOYAU_AVX2)
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 16 <= n; i += 16) {
+        __m256i t = _mm256_loadu_si256((const __m256i*)(ttl + i));
+        __m256i m = _mm256_cmpgt_epi16(t, zero);
+        __m256i px = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i py = _mm256_loadu_si256((const __m256i*)(y + i));
+        px = _mm256_add_epi16(px, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(vx + i)), m));
+        py = _mm256_add_epi16(py, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(vy + i)), m));
+        t = _mm256_add_epi16(t, m); /* m vaut -1 sur les particules vivantes */
+        _mm256_storeu_si256((__m256i*)(x + i), px);
+        _mm256_storeu_si256((__m256i*)(y + i), py);
+        _mm256_storeu_si256((__m256i*)(ttl + i), t);
+    }
+#elif defined(NOYAU_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i t = _mm_loadu_si128((const __m128i*)(ttl + i));
+        __m128i m = _mm_cmpgt_epi16(t, zero);
+        __m128i px = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i py = _mm_loadu_si128((const __m128i*)(y + i));
+        px = _mm_add_epi16(px, _mm_and_si128(_mm_loadu_si128((const __m128i*)(vx + i)), m));
+        py = _mm_add_epi16(py, _mm_and_si128(_mm_loadu_si128((const __m128i*)(vy + i)), m));
+        t = _mm_add_epi16(t, m);
+        _mm_storeu_si128((__m128i*)(x + i), px);
+        _mm_storeu_si128((__m128i*)(y + i), py);
+        _mm_storeu_si128((__m128i*)(ttl + i), t);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (ttl[i] <= 0) continue;
+        x[i] = (int16_t)(x[i] + vx[i]);
+        y[i] = (int16_t)(y[i] + vy[i]);
+        ttl[i] = (int16_t)(ttl[i] - 1);
+    }
+}
+
+void noyau_avancer_projectiles(int16_t* y, const int16_t* dy, uint8_t* actif, int n, int hauteur) {
+    int i = 0;
+#if defined(NOYAU_AVX2)
+    const __m256i moins_un = _mm256_set1_epi16(-1);
+    const __m256i h = _mm256_set1_epi16((int16_t)hauteur);
+    for (; i + 16 <= n; i += 16) {
+        __m256i m = etendre_masques(actif + i);
+        __m256i py = _mm256_loadu_si256((const __m256i*)(y + i));
+        py = _mm256_add_epi16(py, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(dy + i)), m));
+        __m256i dedans = _mm256_and_si256(_mm256_cmpgt_epi16(py, moins_un), _mm256_cmpgt_epi16(h, py));
+        m = _mm256_and_si256(m, dedans);
+        _mm256_storeu_si256((__m256i*)(y + i), py);
+        _mm_storeu_si128((__m128i*)(actif + i),
+                         _mm_packs_epi16(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1)));
+    }
+#elif defined(NOYAU_SSE2)
+    const __m128i moins_un = _mm_set1_epi16(-1);
+    const __m128i h = _mm_set1_epi16((int16_t)hauteur);
+    for (; i + 16 <= n; i += 16) {
+        __m128i m0, m1;
+        etendre_masques(actif + i, &m0, &m1);
+        __m128i y0 = _mm_loadu_si128((const __m128i*)(y + i));
+        __m128i y1 = _mm_loadu_si128((const __m128i*)(y + i + 8));
+        y0 = _mm_add_epi16(y0, _mm_and_si128(_mm_loadu_si128((const __m128i*)(dy + i)), m0));
+        y1 = _mm_add_epi16(y1, _mm_and_si128(_mm_loadu_si128((const __m128i*)(dy + i + 8)), m1));
+        m0 = _mm_and_si128(m0, _mm_and_si128(_mm_cmpgt_epi16(y0, moins_un), _mm_cmpgt_epi16(h, y0)));
+        m1 = _mm_and_si128(m1, _mm_and_si128(_mm_cmpgt_epi16(y1, moins_un), _mm_cmpgt_epi16(h, y1)));
+        _mm_storeu_si128((__m128i*)(y + i), y0);
+        _mm_storeu_si128((__m128i*)(y + i + 8), y1);
+        _mm_storeu_si128((__m128i*)(actif + i), _mm_packs_epi16(m0, m1));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (!actif[i]) continue;
+        y[i] = (int16_t)(y[i] + dy[i]);
+        if (y[i] < 0 || y[i] >= hauteur) actif[i] = 0;
+    }
+}
+
+#if defined(NOYAU_AVX2) || defined(NOYAU_SSE2)
+/* Octets de `o` hors de [bas, haut] : non nuls dans le résultat (ramener un
+ * octet dans l'intervalle le change s'il en sort) */
+static __m128i ecarts_octets(__m128i o, __m128i bas, __m128i haut) {
+    return _mm_xor_si128(o, _mm_min_epu8(_mm_max_epu8(o, bas), haut));
+}
+#endif
+
+#if defined(NOYAU_AVX2)
+static __m256i ecarts_octets_256(__m256i o, __m256i bas, __m256i haut) {
+    return _mm256_xor_si256(o, _mm256_min_epu8(_mm256_max_epu8(o, bas), haut));
+}
+#endif
+
+int noyau_octets_hors(const uint8_t* v, int n, uint8_t min, uint8_t max) {
+    /* le dernier bloc recouvre le précédent plutôt que de finir en scalaire */
+#if defined(NOYAU_AVX2)
+    if (n >= 32) {
+        const __m256i bas = _mm256_set1_epi8((char)min), haut = _mm256_set1_epi8((char)max);
+        __m256i ecarts = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 32 <= n; i += 32)
+            ecarts = _mm256_or_si256(ecarts, ecarts_octets_256(_mm256_loadu_si256((const __m256i*)(v + i)), bas, haut));
+        if (i < n)
+            ecarts = _mm256_or_si256(ecarts, ecarts_octets_256(_mm256_loadu_si256((const __m256i*)(v + n - 32)), bas, haut));
+        return !_mm256_testz_si256(ecarts, ecarts);
+    }
+#endif
+#if defined(NOYAU_AVX2) || defined(NOYAU_SSE2)
+    if (n >= 16) {
+        const __m128i bas = _mm_set1_epi8((char)min), haut = _mm_set1_epi8((char)max);
+        __m128i ecarts = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+            ecarts = _mm_or_si128(ecarts, ecarts_octets(_mm_loadu_si128((const __m128i*)(v + i)), bas, haut));
+        if (i < n)
+            ecarts = _mm_or_si128(ecarts, ecarts_octets(_mm_loadu_si128((const __m128i*)(v + n - 16)), bas, haut));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ecarts, _mm_setzero_si128())) != 0xFFFF;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        if (v[i] < min || v[i] > max) return 1;
+    return 0;
+}
+
+void grille_lier(Grille* g, uint64_t* stockage, int largeur, int hauteur) {
+    g->mots = stockage;
+    g->mots_par_ligne = (largeur + 63) / 64;
+    g->largeur = largeur;
+    g->hauteur = hauteur;
+    grille_vider(g);
+}
+
+void grille_vider(Grille* g) {
+    memset(g->mots, 0, grille_nombre_mots(g->largeur, g->hauteur) * sizeof(uint64_t));
+}
+
+/* Ramène [y_min, y_max] dans la grille. @return 0 si l'intervalle est vide */
+static int borner_lignes(const Grille* g, int* y_min, int* y_max) {
+    if (*y_min < 0) *y_min = 0;
+    if (*y_max > g->hauteur - 1) *y_max = g->hauteur - 1;
+    return *y_min <= *y_max;
+}
+
+void grille_vider_lignes(Grille* g, int y_min, int y_max) {
+    if (!borner_lignes(g, &y_min, &y_max)) return;
+    const size_t ligne = (size_t)g->mots_par_ligne;
+    memset(&g->mots[(size_t)y_min * ligne], 0, (size_t)(y_max - y_min + 1) * ligne * sizeof(uint64_t));
+}
@@ -0,0 +1,298 @@
+/*
+ * rejeu.c
+ * -------
+ * Écriture des fichiers de rejeu (appelée par le contrôleur) et mode
+ * `--replay` : lecture du fichier projeté en mémoire, commandes renvoyées
+ * au contrôleur, ticks mesurés un par un.
+ */
+
+#include "rejeu.h"
+#include "sauvegarde.h"
+#include "simulation.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CODE_FIN 6
+#define CODE_IMAGE 7
+
+struct Enregistreur {
+    FILE* f;
+    uint64_t dernier_tick;   /* tick du modèle au dernier enregistrement */
+    uint64_t derniere_image; /* tick du modèle à la dernière image clé */
+    uint64_t intervalle;
+    unsigned char* blob;     /* tampon des images clés (taille maximale de la partie) */
+    size_t capacite;
+    int erreur;
+};
+
+static void ecrire_varint(Enregistreur* r, uint64_t v) {
+    unsigned char octets[10];
+    int n = 0;
+    do {
+        unsigned char o = (unsigned char)(v & 0x7F);
+        v >>= 7;
+        octets[n++] = (unsigned char)(o | (v ? 0x80 : 0));
+    } while (v);
+    if (fwrite(octets, 1, (size_t)n, r->f) != (size_t)n) r->erreur = 1;
+}
+
+/* Delta depuis l'enregistrement précédent ; le tick ne recule qu'après
+ * CMD_RECOMMENCER, qui remet aussi la référence à zéro */
+static void ecrire_entete_enregistrement(Enregistreur* r, const EtatJeu* e, unsigned code) {
+    uint64_t tick = etatjeu_obtenir_tick(e);
+    uint64_t delta = tick >= r->dernier_tick ? tick - r->dernier_tick : 0;
+    ecrire_varint(r, (delta << 3) | code);
+    r->dernier_tick = tick;
+}
+
+static void ecrire_image(Enregistreur* r, const EtatJeu* e) {
+    size_t taille = etatjeu_sauver(e, r->blob, r->capacite);
+    ecrire_entete_enregistrement(r, e, CODE_IMAGE);
+    ecrire_varint(r, taille);
+    if (fwrite(r->blob, 1, taille, r->f) != taille) r->erreur = 1;
+    r->derniere_image = r->dernier_tick;
+}
+
+Enregistreur* rejeu_enregistrer_ouvrir(const char* chemin, const EtatJeu* e, int intervalle) {
+    if (!chemin || !e) return NULL;
+    Enregistreur* r = (Enregistreur*)calloc(1, sizeof(Enregistreur));
+    if (!r) return NULL;
+    r->capacite = etatjeu_sauvegarde_taille_max(e);
+    r->blob = (unsigned char*)malloc(r->capacite);
+    r->f = fopen(chemin, "wb");
+    if (!r->blob || !r->f) {
+        if (r->f) fclose(r->f);
+        free(r->blob);
+        free(r);
+        return NULL;
+    }
+    r->intervalle = (uint64_t)(intervalle > 0 ? intervalle : REJEU_INTERVALLE_DEFAUT);
+    r->dernier_tick = etatjeu_obtenir_tick(e);
+
+    EnteteRejeu h;
+    memset(&h, 0, sizeof(h));
+    h.magic = REJEU_MAGIC;
+    h.version = REJEU_VERSION;
+    h.taille_entete = (uint16_t)sizeof(h);
+    h.graine = etatjeu_obtenir_graine(e);
+    h.intervalle = (uint32_t)r->intervalle;
+    if (fwrite(&h, sizeof(h), 1, r->f) != 1) r->erreur = 1;
+    ecrire_image(r, e);
+    return r;
+}
+
+void rejeu_enregistrer_commande(Enregistreur* r, const EtatJeu* e, Commande c) {
+    if (!r || !e) return;
+    if (etatjeu_obtenir_tick(e) >= r->derniere_image + r->intervalle) ecrire_image(r, e);
+    ecrire_entete_enregistrement(r, e, (unsigned)c);
+    if (c == CMD_RECOMMENCER) {
+        r->dernier_tick = 0;
+        r->derniere_image = 0;
+    }
+}
+
+int rejeu_enregistrer_fermer(Enregistreur* r, const EtatJeu* e) {
+    if (!r) return 1;
+    if (e) ecrire_entete_enregistrement(r, e, CODE_FIN);
+    int rc = r->erreur;
+    if (fclose(r->f) != 0) rc = 1;
+    free(r->blob);
+    free(r);
+    return rc;
+}
+
+/* --- Lecture --- */
+
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* fin;
+} Lecteur;
+
+typedef struct {
+    const unsigned char* debut; /* position de l'enregistrement dans le fichier */
+    uint64_t delta;
+    unsigned code;
+    const unsigned char* blob;  /* image clé */
+    size_t taille;
+} Enregistrement;
+
+static int lire_varint(Lecteur* l, uint64_t* v) {
+    uint64_t x = 0;
+    for (int decalage = 0; decalage < 64 && l->p < l->fin; decalage += 7) {
+        unsigned char o = *l->p++;
+        x |= (uint64_t)(o & 0x7F) << decalage;
+        if (!(o & 0x80)) {
+            *v = x;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* @return 1 si un enregistrement complet a été lu, 0 en fin de fichier (ou fichier tronqué) */
+static int lire_enregistrement(Lecteur* l, Enregistrement* en) {
+    uint64_t v;
+    en->debut = l->p;
+    if (!lire_varint(l, &v)) return 0;
+    en->delta = v >> 3;
+    en->code = (unsigned)(v & 7);
+    en->blob = NULL;
+    en->taille = 0;
+    if (en->code == CODE_IMAGE) {
+        uint64_t taille;
+        if (!lire_varint(l, &taille) || taille > (uint64_t)(l->fin - l->p)) return 0;
+        en->blob = l->p;
+        en->taille = (size_t)taille;
+        l->p += taille;
+    }
+    return 1;
+}
+
+int rejeu_executer(const ConfigRejeu* c) {
+    if (!c || !c->chemin) return 1;
+    FichierSauvegarde f;
+    if (sauvegarde_ouvrir(&f, c->chemin) != 0) {
+        fprintf(stderr, "Fichier de rejeu illisible '%s'\n", c->chemin);
+        return 1;
+    }
+    EnteteRejeu h;
+    memset(&h, 0, sizeof(h));
+    if (f.taille >= sizeof(h)) memcpy(&h, f.donnees, sizeof(h));
+    if (h.magic != REJEU_MAGIC || h.version != REJEU_VERSION || h.taille_entete != sizeof(h)) {
+        fprintf(stderr, "'%s' n'est pas un fichier de rejeu valide\n", c->chemin);
+        sauvegarde_fermer(&f);
+        return 1;
+    }
+
+    const unsigned char* donnees = (const unsigned char*)f.donnees;
+    Lecteur l = { donnees + sizeof(h), donnees + f.taille };
+    Enregistrement en;
+
+    /* Recherche de l'image clé : parcours des enregistrements sans simuler,
+     * les blobs sont sautés grâce à leur taille. `base` cumule les ticks des
+     * parties terminées par CMD_RECOMMENCER (tick de session = base + tick). */
+    uint64_t dernier = 0, base = 0;
+    const unsigned char* reprise = l.p;
+    uint64_t reprise_dernier = 0, reprise_base = 0;
+    if (c->tick_depart > 0) {
+        Lecteur parcours = l;
+        while (lire_enregistrement(&parcours, &en)) {
+            uint64_t tick = dernier + en.delta;
+            if (base + tick > (uint64_t)c->tick_depart) break;
+            if (en.code == CODE_IMAGE) {
+                reprise = en.debut;
+                reprise_dernier = dernier;
+                reprise_base = base;
+            }
+            dernier = tick;
+            if (en.code == CMD_RECOMMENCER) { base += tick; dernier = 0; }
+        }
+    }
+    l.p = reprise;
+    dernier = reprise_dernier;
+    base = reprise_base;
+
+    HistogrammeLatence histo;
+    histo_initialiser(&histo);
+    EtatJeu* e = NULL;
+    unsigned char* verif = NULL;
+    size_t capacite = 0;
+    long ticks = 0, commandes = 0, images = 0, ecarts = 0;
+    uint64_t tick_lent = 0, ns_lent = 0, session_depart = 0;
+    CurseurEvenements curseur = { 0, 0 };
+    Evenement lus[64];
+    long evenements[EVT_NOMBRE_TYPES] = { 0 };
+    int fin = 0, erreur = 0;
+    uint64_t debut = horloge_ns();
+
+    while (!fin && !erreur && lire_enregistrement(&l, &en)) {
+        uint64_t tick = dernier + en.delta;
+        if (!e) {
+            /* premier enregistrement lu : l'image clé de départ */
+            if (en.code != CODE_IMAGE || !(e = etatjeu_creer_depuis_sauvegarde(en.blob, en.taille))) {
+                erreur = 1;
+                break;
+            }
+            capacite = etatjeu_sauvegarde_taille_max(e);
+            verif = (unsigned char*)malloc(capacite);
+            if (!verif) { erreur = 1; break; }
+            session_depart = base + tick;
+            etatjeu_evenements_suivre(e, &curseur);
+        }
+        if (etatjeu_obtenir_tick(e) > tick) { erreur = 1; break; } /* fichier incohérent */
+
+        /* ticks jusqu'au prochain enregistrement, mesurés un par un */
+        while (etatjeu_obtenir_tick(e) < tick) {
+            if (c->ticks_max > 0 && ticks >= c->ticks_max) { fin = 1; break; }
+            uint64_t t0 = horloge_ns();
+            etatjeu_tick(e);
+            uint64_t duree = horloge_ns() - t0;
+            histo_ajouter(&histo, duree);
+            if (duree > ns_lent) {
+                ns_lent = duree;
+                tick_lent = base + etatjeu_obtenir_tick(e) - 1;
+            }
+            ++ticks;
+            int n;
+            while ((n = etatjeu_evenements_lire(e, &curseur, lus, 64)) > 0) {
+                for (int i = 0; i < n; ++i) evenements[lus[i].type] += 1;
+            }
+        }
+        if (fin) break;
+
+        if (en.code == CODE_IMAGE) {
+            /* la partie rejouée doit être exactement celle de l'image clé */
+            size_t taille = etatjeu_sauver(e, verif, capacite);
+            if (taille != en.taille || memcmp(verif, en.blob, taille) != 0) ++ecarts;
+            ++images;
+        } else if (en.code == CODE_FIN) {
+            fin = 1;
+        } else {
+            controleur_appliquer_commande(e, (Commande)en.code);
+            ++commandes;
+        }
+        dernier = tick;
+        if (en.code == CMD_RECOMMENCER) { base += tick; dernier = 0; }
+    }
+    uint64_t duree_ns = horloge_ns() - debut;
+
+    if (!e || erreur) {
+        fprintf(stderr, "Fichier de rejeu corrompu '%s'\n", c->chemin);
+    } else {
+        double secondes = (double)duree_ns / 1e9;
+        if (secondes <= 0.0) secondes = 1e-9;
+        printf("=== Rejeu ===\n");
+        printf("fichier     : %s (%zu octets)  graine : %llu  images cles tous les %u ticks\n", c->chemin,
+               f.taille, (unsigned long long)h.graine, h.intervalle);
+        printf("depart      : tick %llu", (unsigned long long)session_depart);
+        if (c->tick_depart > 0) printf(" (image cle precedant le tick %ld)", c->tick_depart);
+        printf("\n");
+        printf("ticks       : %ld  commandes : %ld%s\n", ticks, commandes, fin ? "" : "  (fichier sans fin)");
+        printf("images cles : %ld verifiees, %ld ecart(s)\n", images, ecarts);
+        printf("duree       : %.3f s\n", secondes);
+        printf("ticks/s     : %.0f\n", (double)ticks / secondes);
+        printf("latence par tick (ns) :\n");
+        printf("  min %llu  p50 %llu  p90 %llu  p99 %llu  p99.9 %llu  max %llu  moyenne %.1f\n",
+               (unsigned long long)(histo.nombre ? histo.min : 0),
+               (unsigned long long)histo_percentile(&histo, 0.50),
+               (unsigned long long)histo_percentile(&histo, 0.90),
+               (unsigned long long)histo_percentile(&histo, 0.99),
+               (unsigned long long)histo_percentile(&histo, 0.999),
+               (unsigned long long)histo.max,
+               histo.nombre ? histo.somme / (double)histo.nombre : 0.0);
+        if (ticks > 0) printf("tick le plus lent : %llu (%llu ns)\n", (unsigned long long)tick_lent, (unsigned long long)ns_lent);
+        printf("evenements  : %ld ennemis tues, %ld boucliers touches, %ld vaisseau touche, %ld vagues, %ld game over\n",
+               evenements[EVT_ENNEMI_TUE], evenements[EVT_BOUCLIER_TOUCHE], evenements[EVT_JOUEUR_TOUCHE],
+               evenements[EVT_VAGUE_TERMINEE], evenements[EVT_GAME_OVER]);
+        printf("score       : %d  niveau : %d  vies : %d\n", etatjeu_obtenir_score(e), etatjeu_obtenir_niveau(e),
+               etatjeu_obtenir_vies(e));
+    }
+
+    int rc = (!e || erreur || ecarts > 0) ? 1 : 0;
+    etatjeu_detruire(e);
+    free(verif);
+    sauvegarde_fermer(&f);
+    return rc;
+}
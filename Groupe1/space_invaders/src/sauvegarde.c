@@ -0,0 +1,101 @@
+/*
+ * sauvegarde.c
+ * ------------
+ * Écriture et lecture des fichiers de sauvegarde. Le format est celui de
+ * `etatjeu_sauver` (voir model.h) ; ce fichier ne s'occupe que du disque.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sauvegarde.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int sauvegarde_ecrire(const EtatJeu* e, const char* chemin) {
+    if (!e || !chemin) return 1;
+    size_t capacite = etatjeu_sauvegarde_taille_max(e);
+    void* blob = malloc(capacite);
+    if (!blob) return 1;
+    size_t taille = etatjeu_sauver(e, blob, capacite);
+
+    int rc = 1;
+    FILE* f = fopen(chemin, "wb");
+    if (f) {
+        if (taille > 0 && fwrite(blob, 1, taille, f) == taille) rc = 0;
+        if (fclose(f) != 0) rc = 1;
+    }
+    free(blob);
+    return rc;
+}
+
+/* Repli sans mmap : le fichier est lu entièrement dans un tampon */
+static int lire_fichier(FichierSauvegarde* f, const char* chemin) {
+    FILE* fp = fopen(chemin, "rb");
+    if (!fp) return 1;
+    long taille = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) taille = ftell(fp);
+    void* donnees = taille > 0 ? malloc((size_t)taille) : NULL;
+    if (!donnees || fseek(fp, 0, SEEK_SET) != 0 || fread(donnees, 1, (size_t)taille, fp) != (size_t)taille) {
+        free(donnees);
+        fclose(fp);
+        return 1;
+    }
+    fclose(fp);
+    f->donnees = donnees;
+    f->taille = (size_t)taille;
+    f->projete = 0;
+    return 0;
+}
+
+int sauvegarde_ouvrir(FichierSauvegarde* f, const char* chemin) {
+    if (!f || !chemin) return 1;
+    f->donnees = NULL;
+    f->taille = 0;
+    f->projete = 0;
+#ifdef _WIN32
+    return lire_fichier(f, chemin);
+#else
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0) return 1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 1;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* la projection reste valide après la fermeture */
+    if (p == MAP_FAILED) return lire_fichier(f, chemin);
+    f->donnees = p;
+    f->taille = (size_t)st.st_size;
+    f->projete = 1;
+    return 0;
+#endif
+}
+
+void sauvegarde_fermer(FichierSauvegarde* f) {
+    if (!f || !f->donnees) return;
+#ifndef _WIN32
+    if (f->projete) munmap((void*)f->donnees, f->taille);
+    else
+#endif
+        free((void*)f->donnees);
+    f->donnees = NULL;
+    f->taille = 0;
+    f->projete = 0;
+}
+
+EtatJeu* sauvegarde_charger(const char* chemin) {
+    FichierSauvegarde f;
+    if (sauvegarde_ouvrir(&f, chemin) != 0) return NULL;
+    EtatJeu* e = etatjeu_creer_depuis_sauvegarde(f.donnees, f.taille);
+    sauvegarde_fermer(&f);
+    return e;
+}
@@ -0,0 +1,132 @@
+/*
+ * simulation.c
+ * ------------
+ * Outils partagés par les modes sans interface : politiques d'entrée
+ * automatiques, horloge monotone et histogramme de latence.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "simulation.h"
+#include "controller.h"
+
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static uint32_t xorshift32(uint32_t* etat) {
+    uint32_t x = *etat;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *etat = x;
+    return x;
+}
+
+void politique_initialiser(PolitiqueEntree* p, TypePolitique type, const char* script, unsigned int graine) {
+    if (!p) return;
+    p->type = type;
+    p->script = (script && script[0]) ? script : SCRIPT_DEFAUT;
+    p->position = 0;
+    p->alea = graine ? (uint32_t)graine : 0x9E3779B9u; /* xorshift ne doit pas partir de 0 */
+}
+
+void politique_appliquer(PolitiqueEntree* p, EtatJeu* e) {
+    if (!p || !e) return;
+    switch (p->type) {
+        case POLITIQUE_ALEATOIRE: {
+            uint32_t r = xorshift32(&p->alea) % 10;
+            if (r < 3) controleur_appliquer_commande(e, CMD_GAUCHE);
+            else if (r < 6) controleur_appliquer_commande(e, CMD_DROITE);
+            else if (r < 8) controleur_appliquer_commande(e, CMD_TIRER);
+            break;
+        }
+        case POLITIQUE_SCRIPT: {
+            char c = p->script[p->position];
+            if (c == '\0') { p->position = 0; c = p->script[0]; }
+            p->position++;
+            if (c == 'g') controleur_appliquer_commande(e, CMD_GAUCHE);
+            else if (c == 'd') controleur_appliquer_commande(e, CMD_DROITE);
+            else if (c == 't') controleur_appliquer_commande(e, CMD_TIRER);
+            break;
+        }
+        case POLITIQUE_INACTIVE:
+        default:
+            break;
+    }
+}
+
+int politique_depuis_nom(const char* nom) {
+    if (!nom) return -1;
+    if (strcmp(nom, "random") == 0) return POLITIQUE_ALEATOIRE;
+    if (strcmp(nom, "script") == 0) return POLITIQUE_SCRIPT;
+    if (strcmp(nom, "idle") == 0) return POLITIQUE_INACTIVE;
+    return -1;
+}
+
+uint64_t horloge_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequence;
+    LARGE_INTEGER compteur;
+    if (frequence.QuadPart == 0) QueryPerformanceFrequency(&frequence);
+    QueryPerformanceCounter(&compteur);
+    return (uint64_t)((double)compteur.QuadPart * 1e9 / (double)frequence.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Position du bit de poids fort (v > 0) */
+static int bit_fort(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int p = 0;
+    while (v >>= 1) ++p;
+    return p;
+#endif
+}
+
+static int histo_index(uint64_t v) {
+    if (v < HISTO_SOUS_SEAUX) return (int)v;
+    int p = bit_fort(v);
+    int sous = (int)((v >> (p - 4)) & (HISTO_SOUS_SEAUX - 1));
+    return (p - 3) * HISTO_SOUS_SEAUX + sous;
+}
+
+static uint64_t histo_borne(int idx) {
+    if (idx < HISTO_SOUS_SEAUX) return (uint64_t)idx;
+    int p = idx / HISTO_SOUS_SEAUX + 3;
+    uint64_t sous = (uint64_t)(idx % HISTO_SOUS_SEAUX);
+    return (HISTO_SOUS_SEAUX + sous) << (p - 4);
+}
+
+void histo_initialiser(HistogrammeLatence* h) {
+    if (!h) return;
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+void histo_ajouter(HistogrammeLatence* h, uint64_t valeur) {
+    h->seaux[histo_index(valeur)]++;
+    h->nombre++;
+    h->somme += (double)valeur;
+    if (valeur < h->min) h->min = valeur;
+    if (valeur > h->max) h->max = valeur;
+}
+
+uint64_t histo_percentile(const HistogrammeLatence* h, double q) {
+    if (!h || h->nombre == 0) return 0;
+    uint64_t rang = (uint64_t)(q * (double)(h->nombre - 1));
+    uint64_t cumul = 0;
+    for (int i = 0; i < HISTO_NB_SEAUX; ++i) {
+        cumul += h->seaux[i];
+        if (cumul > rang) return histo_borne(i);
+    }
+    return h->max;
+}
@@ -1,6 +1,8 @@
 #include "text_bitmap.h"
 
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Rectangle utilitaire pour dessiner des glyphes */
 static void draw_rect(SDL_Renderer* renderer, int x, int y, int w, int h, SDL_Color color) {
@@ -77,8 +79,267 @@ static int draw_glyph(SDL_Renderer* renderer, int x, int y, char ch, SDL_Color c
     return advance;
 }
 
+/* Caractères présents dans l'atlas, dans l'ordre des cases */
+static const char atlas_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789<>#.:-";
+#define ATLAS_NB_GLYPHES ((int)sizeof(atlas_chars) - 1)
+#define ATLAS_COLONNES 8
+/* Case d'un glyphe : 5x7 pixels de police plus une bordure transparente */
+#define ATLAS_BORD 1
+/* Caractères par soumission ; une chaîne plus longue part en plusieurs */
+#define ATLAS_LOT 64
+
+typedef struct {
+    SDL_Renderer* renderer;
+    int pixel;
+    SDL_Texture* texture;
+    int case_l, case_h; /* taille d'une case en texels */
+    float texture_l, texture_h;
+} AtlasPolice;
+
+static AtlasPolice atlas[BITMAP_ATLAS_MAX];
+static int atlas_prochain; /* remplacé quand tout est pris */
+
+static int atlas_index(char c) {
+    const char* p = strchr(atlas_chars, c);
+    return (c && p) ? (int)(p - atlas_chars) : -1;
+}
+
+/* Pose le glyphe `pat` à la taille `pixel`, en blanc, en (x0, y0) de `texels` */
+static void rasteriser_glyphe(Uint32* texels, int largeur, int x0, int y0, const char* pat, int pixel) {
+    for (int row = 0; row < 7; ++row)
+        for (int col = 0; col < 5; ++col) {
+            if (pat[row * 5 + col] != '#') continue;
+            for (int py = 0; py < pixel; ++py)
+                for (int px = 0; px < pixel; ++px)
+                    texels[(size_t)(y0 + row * pixel + py) * largeur + x0 + col * pixel + px] = 0xFFFFFFFFu;
+        }
+}
+
+/* Texture blanche de `largeur` x `hauteur` texels, mélange alpha, échantillonnage au plus proche */
+static SDL_Texture* texture_blanche(SDL_Renderer* renderer, const Uint32* texels, int largeur, int hauteur) {
+    SDL_Texture* t = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, largeur, hauteur);
+    if (!t) return NULL;
+    if (!SDL_UpdateTexture(t, NULL, texels, largeur * (int)sizeof(Uint32))) {
+        SDL_DestroyTexture(t);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(t, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(t, SDL_SCALEMODE_NEAREST);
+    return t;
+}
+
+/* Rastérise toute la police à la taille `pixel` dans une texture blanche */
+static int atlas_creer(AtlasPolice* a, SDL_Renderer* renderer, int pixel) {
+    int case_l = 5 * pixel + 2 * ATLAS_BORD, case_h = 7 * pixel + 2 * ATLAS_BORD;
+    int lignes = (ATLAS_NB_GLYPHES + ATLAS_COLONNES - 1) / ATLAS_COLONNES;
+    int largeur = ATLAS_COLONNES * case_l, hauteur = lignes * case_h;
+    Uint32* texels = (Uint32*)calloc((size_t)largeur * (size_t)hauteur, sizeof(Uint32));
+    if (!texels) return 1;
+    for (int g = 0; g < ATLAS_NB_GLYPHES; ++g) {
+        const char* pat = glyph_pattern(atlas_chars[g]);
+        if (!pat) continue;
+        int x0 = (g % ATLAS_COLONNES) * case_l + ATLAS_BORD, y0 = (g / ATLAS_COLONNES) * case_h + ATLAS_BORD;
+        rasteriser_glyphe(texels, largeur, x0, y0, pat, pixel);
+    }
+    SDL_Texture* t = texture_blanche(renderer, texels, largeur, hauteur);
+    free(texels);
+    if (!t) return 1;
+    a->renderer = renderer;
+    a->pixel = pixel;
+    a->texture = t;
+    a->case_l = case_l;
+    a->case_h = case_h;
+    a->texture_l = (float)largeur;
+    a->texture_h = (float)hauteur;
+    return 0;
+}
+
+/* Atlas de (renderer, pixel), créé au premier usage ; NULL si impossible */
+static AtlasPolice* atlas_obtenir(SDL_Renderer* renderer, int pixel) {
+    for (int i = 0; i < BITMAP_ATLAS_MAX; ++i)
+        if (atlas[i].texture && atlas[i].renderer == renderer && atlas[i].pixel == pixel) return &atlas[i];
+    AtlasPolice* a = NULL;
+    for (int i = 0; i < BITMAP_ATLAS_MAX && !a; ++i)
+        if (!atlas[i].texture) a = &atlas[i];
+    if (!a) {
+        a = &atlas[atlas_prochain];
+        atlas_prochain = (atlas_prochain + 1) % BITMAP_ATLAS_MAX;
+        SDL_DestroyTexture(a->texture);
+        a->texture = NULL;
+    }
+    return atlas_creer(a, renderer, pixel) == 0 ? a : NULL;
+}
+
+/*
+ * Libellés retenus : chaque chaîne déjà dessinée (par renderer, taille et
+ * espacement) garde sa texture, rastérisée une fois sur le CPU. Un appel
+ * qui la retrouve ne coûte qu'une modulation de couleur et un
+ * `SDL_RenderTexture`. La couleur n'est pas dans la clé : une même chaîne
+ * dans deux couleurs partage sa texture. Au-delà de `BITMAP_LIBELLES_MAX`,
+ * le libellé utilisé le moins récemment est remplacé.
+ */
+typedef struct {
+    SDL_Renderer* renderer;
+    int pixel, spacing;
+    Uint32 hachage;
+    char texte[BITMAP_LIBELLE_LONGUEUR_MAX + 1];
+    SDL_Texture* texture;
+    float largeur, hauteur;
+    Uint64 dernier_usage;
+} Libelle;
+
+static Libelle libelles[BITMAP_LIBELLES_MAX];
+static Uint64 horloge_libelles;
+static BitmapTextStats stats;
+
+static Uint32 hacher(const char* texte) {
+    Uint32 h = 2166136261u;
+    for (const char* c = texte; *c; ++c) {
+        h ^= (Uint8)toupper((unsigned char)*c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Rastérise `texte` (longueur `n`, en majuscules) dans la texture du libellé `l` */
+static int libelle_creer(Libelle* l, SDL_Renderer* renderer, const char* texte, int n, int pixel, int spacing) {
+    int advance = pixel * 5 + spacing;
+    int largeur = (n - 1) * advance + 5 * pixel, hauteur = 7 * pixel;
+    Uint32* texels = (Uint32*)calloc((size_t)largeur * (size_t)hauteur, sizeof(Uint32));
+    if (!texels) return 1;
+    for (int i = 0; i < n; ++i) {
+        const char* pat = glyph_pattern((char)toupper((unsigned char)texte[i]));
+        if (pat) rasteriser_glyphe(texels, largeur, i * advance, 0, pat, pixel);
+    }
+    SDL_Texture* t = texture_blanche(renderer, texels, largeur, hauteur);
+    free(texels);
+    if (!t) return 1;
+    l->texture = t;
+    l->largeur = (float)largeur;
+    l->hauteur = (float)hauteur;
+    stats.rasterisations += 1;
+    return 0;
+}
+
+/* Libellé de `texte`, créé au premier usage ; NULL si la chaîne n'est pas
+ * retenue (vide, trop longue, espacement négatif) ou en cas d'échec */
+static const Libelle* libelle_obtenir(SDL_Renderer* renderer, const char* texte, int pixel, int spacing) {
+    size_t n = strlen(texte);
+    if (n == 0 || n > BITMAP_LIBELLE_LONGUEUR_MAX || spacing < 0) return NULL;
+    Uint32 h = hacher(texte);
+    Libelle* libre = NULL;
+    Libelle* ancien = &libelles[0];
+    for (int i = 0; i < BITMAP_LIBELLES_MAX; ++i) {
+        Libelle* l = &libelles[i];
+        if (!l->texture) {
+            if (!libre) libre = l;
+            continue;
+        }
+        if (l->hachage == h && l->renderer == renderer && l->pixel == pixel && l->spacing == spacing &&
+            strcmp(l->texte, texte) == 0) {
+            l->dernier_usage = ++horloge_libelles;
+            stats.retrouves += 1;
+            return l;
+        }
+        if (l->dernier_usage < ancien->dernier_usage || !ancien->texture) ancien = l;
+    }
+    Libelle* l = libre ? libre : ancien;
+    if (l->texture) {
+        SDL_DestroyTexture(l->texture);
+        stats.evinces += 1;
+    }
+    memset(l, 0, sizeof(*l));
+    if (libelle_creer(l, renderer, texte, (int)n, pixel, spacing) != 0) return NULL;
+    l->renderer = renderer;
+    l->pixel = pixel;
+    l->spacing = spacing;
+    l->hachage = h;
+    memcpy(l->texte, texte, n + 1);
+    l->dernier_usage = ++horloge_libelles;
+    return l;
+}
+
+void bitmap_text_stats(BitmapTextStats* out) {
+    if (out) *out = stats;
+}
+
+void bitmap_font_release(SDL_Renderer* renderer) {
+    for (int i = 0; i < BITMAP_ATLAS_MAX; ++i) {
+        if (atlas[i].texture && atlas[i].renderer == renderer) {
+            SDL_DestroyTexture(atlas[i].texture);
+            memset(&atlas[i], 0, sizeof(atlas[i]));
+        }
+    }
+    for (int i = 0; i < BITMAP_LIBELLES_MAX; ++i) {
+        if (libelles[i].texture && libelles[i].renderer == renderer) {
+            SDL_DestroyTexture(libelles[i].texture);
+            memset(&libelles[i], 0, sizeof(libelles[i]));
+        }
+    }
+}
+
+/* Un quad texturé par caractère, `ATLAS_LOT` caractères par `SDL_RenderGeometry` */
+static void atlas_dessiner(SDL_Renderer* renderer, const AtlasPolice* a, int x, int y, const char* text,
+                           SDL_Color color, int spacing) {
+    static int indices[6 * ATLAS_LOT];
+    static int indices_prets;
+    if (!indices_prets) {
+        for (int q = 0; q < ATLAS_LOT; ++q) {
+            int* ind = indices + 6 * q;
+            ind[0] = 4 * q; ind[1] = 4 * q + 1; ind[2] = 4 * q + 2;
+            ind[3] = 4 * q + 2; ind[4] = 4 * q + 1; ind[5] = 4 * q + 3;
+        }
+        indices_prets = 1;
+    }
+    SDL_Vertex sommets[4 * ATLAS_LOT];
+    SDL_FColor blanc = { 1.0f, 1.0f, 1.0f, 1.0f };
+    SDL_SetTextureColorMod(a->texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(a->texture, color.a);
+
+    int advance = a->pixel * 5 + spacing;
+    int cursor_x = x, n = 0;
+    for (const char* ch = text; ; ++ch) {
+        if (*ch) {
+            int g = atlas_index((char)toupper((unsigned char)*ch));
+            if (g >= 0) {
+                /* la case entière, bordure comprise, décalée d'un bord */
+                float u0 = (float)((g % ATLAS_COLONNES) * a->case_l), v0 = (float)((g / ATLAS_COLONNES) * a->case_h);
+                float x0 = (float)(cursor_x - ATLAS_BORD), y0 = (float)(y - ATLAS_BORD);
+                float x1 = x0 + (float)a->case_l, y1 = y0 + (float)a->case_h;
+                float s0 = u0 / a->texture_l, t0 = v0 / a->texture_h;
+                float s1 = (u0 + (float)a->case_l) / a->texture_l, t1 = (v0 + (float)a->case_h) / a->texture_h;
+                SDL_Vertex* s = sommets + 4 * n++;
+                s[0].position.x = x0; s[0].position.y = y0; s[0].tex_coord.x = s0; s[0].tex_coord.y = t0;
+                s[1].position.x = x1; s[1].position.y = y0; s[1].tex_coord.x = s1; s[1].tex_coord.y = t0;
+                s[2].position.x = x0; s[2].position.y = y1; s[2].tex_coord.x = s0; s[2].tex_coord.y = t1;
+                s[3].position.x = x1; s[3].position.y = y1; s[3].tex_coord.x = s1; s[3].tex_coord.y = t1;
+                for (int i = 0; i < 4; ++i) s[i].color = blanc;
+            }
+            cursor_x += advance;
+        }
+        if (n > 0 && (n == ATLAS_LOT || !*ch)) {
+            SDL_RenderGeometry(renderer, a->texture, sommets, 4 * n, indices, 6 * n);
+            n = 0;
+        }
+        if (!*ch) break;
+    }
+}
+
 void bitmap_draw_text_custom(SDL_Renderer* renderer, int x, int y, const char* text, SDL_Color color, int pixel_size, int spacing) {
     if (!renderer || !text) return;
+    const Libelle* l = pixel_size > 0 ? libelle_obtenir(renderer, text, pixel_size, spacing) : NULL;
+    if (l) {
+        SDL_FRect dst = { (float)x, (float)y, l->largeur, l->hauteur };
+        SDL_SetTextureColorMod(l->texture, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(l->texture, color.a);
+        SDL_RenderTexture(renderer, l->texture, NULL, &dst);
+        return;
+    }
+    const AtlasPolice* a = pixel_size > 0 ? atlas_obtenir(renderer, pixel_size) : NULL;
+    if (a) {
+        atlas_dessiner(renderer, a, x, y, text, color, spacing);
+        return;
+    }
     int cursor_x = x;
     for (const char* ch = text; *ch; ++ch) {
         cursor_x += draw_glyph(renderer, cursor_x, y, *ch, color, pixel_size, spacing);
@@ -0,0 +1,375 @@
+/*
+ * view_ansi.c
+ * -----------
+ * Vue texte sans ncurses : mode brut termios et séquences ANSI écrites à la
+ * main. Les cases à redessiner viennent du calque du modèle
+ * (`etatjeu_calque_actualiser`) ; une copie de l'écran du terminal
+ * (`ecran`) évite de renvoyer une case qui n'a pas changé. Toute l'image
+ * est construite dans `Sortie`, puis écrite d'un seul `write()`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "view_ansi.h"
+#include "controller.h"
+#include "simulation.h"
+#include "cadence.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int vue_ansi_executer(EtatJeu* e) {
+    (void)e;
+    fprintf(stderr, "Vue ANSI non disponible sous Windows (termios absent).\n");
+    return 1;
+}
+
+#else
+
+/* Caractère et couleur (code SGR 30 + n) de chaque code CASE_* ; une case
+ * vide s'écrit avec n'importe quelle couleur de texte */
+static const char glyphes[CASE_NOMBRE_CODES] = { ' ', 'W', '|', '!', '#', '*', '^', 'W' };
+static const int couleurs[CASE_NOMBRE_CODES] = { -1, 1, 3, 5, 2, 3, 6, 1 };
+#define COULEUR_TEXTE 7
+
+/* Tampon de l'image en cours, avec la position du curseur et la couleur
+ * du terminal une fois tout ce qu'il contient écrit */
+typedef struct {
+    char* octets;
+    size_t taille;
+    size_t capacite;
+    int ligne, colonne; /* position du curseur, 0-indexée ; -1 si inconnue */
+    int couleur;        /* couleur de texte courante ; -1 si inconnue */
+} Sortie;
+
+static void ajouter(Sortie* s, const char* octets, size_t n) {
+    if (s->taille + n > s->capacite) return; /* dimensionné pour le pire cas : n'arrive pas */
+    memcpy(s->octets + s->taille, octets, n);
+    s->taille += n;
+}
+
+static void ajouter_texte(Sortie* s, const char* texte) {
+    ajouter(s, texte, strlen(texte));
+}
+
+/* Écrit "\x1b[<n><final>" */
+static void ajouter_sequence(Sortie* s, int n, char final) {
+    char seq[16];
+    int l = snprintf(seq, sizeof(seq), "\x1b[%d%c", n, final);
+    ajouter(s, seq, (size_t)l);
+}
+
+/* Amène le curseur en (ligne, colonne) par le plus court chemin */
+static void deplacer(Sortie* s, int ligne, int colonne) {
+    /* un texte centré sur un petit terminal donnerait une position négative */
+    if (ligne < 0) ligne = 0;
+    if (colonne < 0) colonne = 0;
+    if (s->ligne == ligne && s->colonne == colonne) return;
+    if (s->ligne == ligne && s->colonne >= 0 && colonne > s->colonne) {
+        ajouter_sequence(s, colonne - s->colonne, 'C');
+    } else {
+        char seq[32];
+        int l = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", ligne + 1, colonne + 1);
+        ajouter(s, seq, (size_t)l);
+    }
+    s->ligne = ligne;
+    s->colonne = colonne;
+}
+
+static void colorer(Sortie* s, int couleur) {
+    if (couleur < 0 || couleur == s->couleur) return;
+    ajouter_sequence(s, 30 + couleur, 'm');
+    s->couleur = couleur;
+}
+
+/* Écrit un caractère à la position du curseur, qui avance d'une colonne */
+static void ecrire_car(Sortie* s, char c) {
+    ajouter(s, &c, 1);
+    s->colonne += 1;
+}
+
+/* Envoie tout le tampon au terminal ; un seul write() sauf écriture partielle */
+static int envoyer(Sortie* s) {
+    size_t fait = 0;
+    while (fait < s->taille) {
+        ssize_t n = write(STDOUT_FILENO, s->octets + fait, s->taille - fait);
+        if (n <= 0) return 1;
+        fait += (size_t)n;
+    }
+    s->taille = 0;
+    return 0;
+}
+
+/* Touches lues sur l'entrée pendant une image : `vues` en bits ENTREE_* */
+typedef struct {
+    unsigned vues;
+    int quitter, recommencer;
+} Touches;
+
+/* Lit tout ce qui est en attente sur l'entrée standard (non bloquante) */
+static int lire_touches(Touches* t) {
+    memset(t, 0, sizeof(*t));
+    unsigned char lu[64];
+    int total = 0;
+    ssize_t n;
+    while ((n = read(STDIN_FILENO, lu, sizeof(lu))) > 0) {
+        total += (int)n;
+        for (ssize_t i = 0; i < n; ++i) {
+            unsigned char c = lu[i];
+            /* flèches : ESC [ C / ESC [ D. Une séquence CSI est lue jusqu'à son
+             * octet final (0x40-0x7E) ; avec paramètres (ESC [ 1 ; 5 D pour
+             * Ctrl+gauche), elle est ignorée au lieu de laisser sa fin passer
+             * pour des touches. */
+            if (c == 0x1b && i + 1 < n && lu[i + 1] == '[') {
+                ssize_t fin = i + 2;
+                while (fin < n && (lu[fin] < 0x40 || lu[fin] > 0x7e)) ++fin;
+                if (fin == i + 2 && fin < n) {
+                    if (lu[fin] == 'D') t->vues |= ENTREE_GAUCHE;
+                    else if (lu[fin] == 'C') t->vues |= ENTREE_DROITE;
+                }
+                i = fin;
+                continue;
+            }
+            /* ESC O C / D en mode application */
+            if (c == 0x1b && i + 2 < n && lu[i + 1] == 'O') {
+                if (lu[i + 2] == 'D') t->vues |= ENTREE_GAUCHE;
+                else if (lu[i + 2] == 'C') t->vues |= ENTREE_DROITE;
+                i += 2;
+                continue;
+            }
+            switch (c) {
+            case 'a': case 'A': t->vues |= ENTREE_GAUCHE; break;
+            case 'd': case 'D': t->vues |= ENTREE_DROITE; break;
+            case ' ': case '\r': case '\n': t->vues |= ENTREE_TIRER; break;
+            case 'p': case 'P': t->vues |= ENTREE_PAUSE; break;
+            case 'r': case 'R': t->recommencer = 1; break;
+            case 'q': case 'Q': case 3: t->quitter = 1; break; /* 3 : Ctrl+C (ISIG est coupé) */
+            default: break;
+            }
+        }
+    }
+    return total;
+}
+
+static void dormir_ms(int ms) {
+    struct timespec d = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&d, NULL);
+}
+
+int vue_ansi_executer(EtatJeu* e) {
+    if (!e) return 1;
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+        fprintf(stderr, "Vue ANSI : l'entrée et la sortie doivent être un terminal.\n");
+        return 1;
+    }
+
+    int lignes_term = 24, colonnes_term = 80;
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        lignes_term = ws.ws_row;
+        colonnes_term = ws.ws_col;
+    }
+
+    /* comme la vue console : la ligne de score, le terrain visible, la ligne de pause */
+    const int largeur = etatjeu_obtenir_largeur(e);
+    const int hauteur = etatjeu_obtenir_hauteur(e);
+    int lignes_visibles = lignes_term - 2;
+    if (lignes_visibles > hauteur) lignes_visibles = hauteur;
+    if (lignes_visibles < 1) lignes_visibles = 1;
+    int colonnes_visibles = colonnes_term < largeur ? colonnes_term : largeur;
+
+    /* pire cas : chaque case visible avec un saut de curseur et une couleur,
+     * plus les lignes de texte */
+    Sortie sortie = { NULL, 0, 0, -1, -1, -1 };
+    sortie.capacite = (size_t)lignes_visibles * (size_t)colonnes_visibles * 24 + 4096;
+    sortie.octets = malloc(sortie.capacite);
+    uint8_t* ecran = malloc((size_t)lignes_visibles * (size_t)colonnes_visibles);
+    if (!sortie.octets || !ecran || etatjeu_calque_actualiser(e) < 0) {
+        free(sortie.octets); free(ecran);
+        return 1;
+    }
+
+    struct termios origine, brut;
+    if (tcgetattr(STDIN_FILENO, &origine) != 0) {
+        free(sortie.octets); free(ecran);
+        return 1;
+    }
+    brut = origine;
+    brut.c_iflag &= ~(tcflag_t)(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+    brut.c_lflag &= ~(tcflag_t)(ECHO | ICANON | IEXTEN | ISIG);
+    brut.c_cc[VMIN] = 0;  /* read() rend la main tout de suite */
+    brut.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &brut);
+
+    /* écran alternatif, curseur caché, gras sur fond noir pour toute la partie */
+    ajouter_texte(&sortie, "\x1b[?1049h\x1b[?25l\x1b[0;1;40m");
+
+    const int temps_image_ms = 50;
+    Cadence cadence;
+    cadence_demarrer(&cadence, 1000 / temps_image_ms);
+    uint64_t instant_prec = horloge_ns();
+    int en_pause = 0, prev_pause = -1;
+    EntreesTick entrees = { 0 };
+    int tout_redessiner = 1;
+    int entete_change = 1;
+    CurseurEvenements curseur;
+    etatjeu_evenements_suivre(e, &curseur);
+    Evenement evenements[64];
+    uint64_t octets_total = 0, temps_total = 0;
+    long images = 0;
+    int rc = 0;
+
+    while (!etatjeu_devrait_quitter(e)) {
+        Touches t;
+        if (etatjeu_est_game_over(e)) {
+            deplacer(&sortie, 0, 0);
+            ajouter_texte(&sortie, "\x1b[2J");
+            colorer(&sortie, 1);
+            char texte[96];
+            deplacer(&sortie, lignes_visibles / 2 - 1, colonnes_visibles / 2 - 10);
+            ajouter_texte(&sortie, "VOUS ETES MORT !");
+            snprintf(texte, sizeof(texte), "Score final: %d", etatjeu_obtenir_score(e));
+            sortie.ligne = -1;
+            deplacer(&sortie, lignes_visibles / 2 + 1, colonnes_visibles / 2 - 15);
+            ajouter_texte(&sortie, texte);
+            sortie.ligne = -1;
+            deplacer(&sortie, lignes_visibles / 2 + 3, colonnes_visibles / 2 - 20);
+            ajouter_texte(&sortie, "Appuyez sur 'r' pour recommencer, 'q' pour quitter");
+            sortie.ligne = -1;
+            if (envoyer(&sortie) != 0) { rc = 1; break; }
+            do {
+                dormir_ms(temps_image_ms);
+                lire_touches(&t);
+            } while (!t.recommencer && !t.quitter);
+            if (t.quitter) { controleur_appliquer_commande(e, CMD_QUITTER); break; }
+            controleur_appliquer_commande(e, CMD_RECOMMENCER);
+            en_pause = 0;
+            controleur_entrees_vider(&entrees);
+            tout_redessiner = 1;
+            instant_prec = horloge_ns(); /* l'attente de la touche ne compte pas */
+            cadence_recaler(&cadence);
+        }
+
+        lire_touches(&t);
+        if (t.quitter) { controleur_appliquer_commande(e, CMD_QUITTER); break; }
+        /* pas de relâchement en terminal : une touche lue pendant l'image
+         * (répétition automatique comprise) compte comme maintenue */
+        controleur_entrees_image(&entrees, t.vues);
+        if (entrees.appuyees & ENTREE_PAUSE) en_pause = !en_pause;
+
+        uint64_t maintenant = horloge_ns();
+        double dt_reel = (double)(maintenant - instant_prec) / 1e9;
+        instant_prec = maintenant;
+        if (!en_pause) controleur_avancer(e, &entrees, dt_reel);
+        else controleur_entrees_vider(&entrees);
+
+        uint64_t debut = horloge_ns();
+        if (etatjeu_calque_actualiser(e) < 0) { rc = 1; break; }
+        const uint8_t* calque = etatjeu_calque(e);
+
+        int n;
+        while ((n = etatjeu_evenements_lire(e, &curseur, evenements, 64)) > 0) {
+            for (int i = 0; i < n; ++i) {
+                if (evenements[i].type == EVT_ENNEMI_TUE || evenements[i].type == EVT_JOUEUR_TOUCHE ||
+                    evenements[i].type == EVT_VAGUE_TERMINEE) entete_change = 1;
+            }
+        }
+        if (curseur.perdus > 0) {
+            entete_change = 1;
+            curseur.perdus = 0;
+        }
+        int pause_change = (en_pause != prev_pause);
+
+        /* redessin complet : l'écran est effacé, seules les cases non vides
+         * du calque sont écrites */
+        if (tout_redessiner) {
+            deplacer(&sortie, 0, 0);
+            ajouter_texte(&sortie, "\x1b[2J");
+            memset(ecran, CASE_VIDE, (size_t)lignes_visibles * (size_t)colonnes_visibles);
+            for (int y = 0; y < lignes_visibles; ++y) {
+                const uint8_t* ligne = calque + (size_t)y * (size_t)largeur;
+                for (int x = 0; x < colonnes_visibles; ++x) {
+                    int code = ligne[x] < CASE_NOMBRE_CODES ? ligne[x] : CASE_VIDE;
+                    if (code == CASE_VIDE) continue;
+                    deplacer(&sortie, y + 1, x);
+                    colorer(&sortie, couleurs[code]);
+                    ecrire_car(&sortie, glyphes[code]);
+                    ecran[(size_t)y * (size_t)colonnes_visibles + (size_t)x] = (uint8_t)code;
+                }
+            }
+            entete_change = 1;
+            pause_change = 1;
+        } else {
+            CurseurPlages plages = { 0, 0 };
+            PlageModifiee plage;
+            while (etatjeu_plage_suivante(e, &plages, &plage) && plage.y < lignes_visibles) {
+                const uint8_t* ligne = calque + (size_t)plage.y * (size_t)largeur;
+                uint8_t* vu = ecran + (size_t)plage.y * (size_t)colonnes_visibles;
+                int x1 = plage.x1 < colonnes_visibles ? plage.x1 : colonnes_visibles;
+                for (int x = plage.x0; x < x1; ++x) {
+                    int code = ligne[x] < CASE_NOMBRE_CODES ? ligne[x] : CASE_VIDE;
+                    if (vu[x] == code) continue;
+                    deplacer(&sortie, plage.y + 1, x);
+                    colorer(&sortie, couleurs[code]);
+                    ecrire_car(&sortie, glyphes[code]);
+                    vu[x] = (uint8_t)code;
+                }
+            }
+        }
+        etatjeu_calque_acquitter(e);
+
+        if (entete_change) {
+            char texte[96];
+            snprintf(texte, sizeof(texte), "Score: %d  Vies: %d  Level: %d",
+                     etatjeu_obtenir_score(e), etatjeu_obtenir_vies(e), etatjeu_obtenir_niveau(e));
+            deplacer(&sortie, 0, 0);
+            colorer(&sortie, COULEUR_TEXTE);
+            ajouter_texte(&sortie, texte);
+            ajouter_texte(&sortie, "\x1b[K");
+            sortie.colonne += (int)strlen(texte);
+        }
+        if (pause_change) {
+            deplacer(&sortie, lignes_visibles + 1, 0);
+            colorer(&sortie, COULEUR_TEXTE);
+            ajouter_texte(&sortie, en_pause ? "-- EN PAUSE --\x1b[K" : "\x1b[K");
+            if (en_pause) sortie.colonne += 14;
+        }
+
+        size_t octets = sortie.taille;
+        if (octets > 0 && envoyer(&sortie) != 0) { rc = 1; break; }
+        temps_total += horloge_ns() - debut;
+        octets_total += octets;
+        images += 1;
+        tout_redessiner = 0;
+        entete_change = 0;
+        prev_pause = en_pause;
+
+        cadence_attendre(&cadence);
+    }
+
+    /* rendre le terminal dans l'état trouvé */
+    sortie.taille = 0;
+    ajouter_texte(&sortie, "\x1b[0m\x1b[?25h\x1b[?1049l");
+    envoyer(&sortie);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &origine);
+    free(sortie.octets);
+    free(ecran);
+
+    if (images > 0)
+        fprintf(stderr, "ansi : %ld images, %.0f octets/image, %.1f us/image (construction + write)\n",
+                images, (double)octets_total / (double)images, (double)temps_total / (double)images / 1e3);
+    cadence_rapport(&cadence, "ansi", stderr);
+    return rc;
+}
+
+#endif /* _WIN32 */
@@ -1,5 +1,7 @@
 #include "view_console.h"
 #include "controller.h"
+#include "simulation.h"
+#include "cadence.h"
 
 #include <ncursesw/curses.h>
 #include <stdlib.h>
@@ -16,91 +18,216 @@ void vue_console_set_bindings(const ConsoleKeyBindings* in) {
     if (in) g_bindings = *in;
 }
 
-static int lire_touche_non_bloquant(void) {
-    int c = getch();
+static int lire_touche_non_bloquant(WINDOW* fenetre) {
+    int c = wgetch(fenetre);
     if (c == ERR) return -1;
     return c;
 }
 
-/* Rendu console basé sur ncursesw. Touches : 'a'/'LEFT' gauche, 'd'/'RIGHT' droite,
- * 'espace' tirer, 'p' pause, 'q' quitter
- */
-int vue_console_executer(EtatJeu* e) {
-    if (!e) return -1;
+/* Couleur de chaque paire PAIRE_*, sur fond noir explicite pour garantir
+ * le contraste dans les terminaux où le fond par défaut s'affiche mal */
+static const short couleurs_paires[PAIRE_NOMBRE] = {
+    0,
+    COLOR_RED,     /* ennemis, game over */
+    COLOR_CYAN,    /* vaisseau */
+    COLOR_YELLOW,  /* projectile joueur */
+    COLOR_MAGENTA, /* projectile ennemi */
+    COLOR_WHITE,   /* UI / texte */
+    COLOR_GREEN,   /* boucliers */
+    COLOR_YELLOW,  /* particules explosion */
+    COLOR_CYAN,    /* titres des menus */
+    COLOR_YELLOW,  /* entrée sélectionnée des menus */
+};
+
+struct ContexteConsole {
+    WINDOW* fenetres[2]; /* ECRAN_MENU, ECRAN_JEU */
+    int couleurs;
+    FILE* rapports;      /* rapports de fin de partie, recopiés après endwin() */
+};
 
-    /* initialisation ncurses */
-    initscr();
+ContexteConsole* vue_console_ouvrir(void) {
+    ContexteConsole* c = (ContexteConsole*)calloc(1, sizeof(ContexteConsole));
+    if (!c) return NULL;
+    if (!initscr()) {
+        free(c);
+        return NULL;
+    }
     cbreak();
     noecho();
     curs_set(0);
-    keypad(stdscr, TRUE);
-    nodelay(stdscr, TRUE);
-    refresh();
 
     /* couleurs : appeler start_color() puis activer si possible.
      * Certains environnements rapportent COLORS via terminfo even si has_colors() est false,
      * donc on vérifie aussi 'COLORS > 1' comme condition de secours.
      */
-    int couleurs_actives = 0;
     start_color();
     if (has_colors() || COLORS > 1) {
-        /* Utiliser un fond noir explicite pour garantir le contraste dans les terminaux
-         * où le fond par défaut ne s'affiche pas correctement. Utiliser aussi
-         * l'attribut gras lors du rendu pour améliorer la visibilité des couleurs.
-         */
-        init_pair(1, COLOR_RED, COLOR_BLACK);     /* ennemis */
-        init_pair(2, COLOR_CYAN, COLOR_BLACK);    /* vaisseau */
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK);  /* projectile joueur */
-        init_pair(4, COLOR_MAGENTA, COLOR_BLACK); /* projectile ennemi */
-        init_pair(5, COLOR_WHITE, COLOR_BLACK);   /* UI / texte */
-        init_pair(6, COLOR_GREEN, COLOR_BLACK);   /* boucliers */
-        init_pair(7, COLOR_YELLOW, COLOR_BLACK);  /* particules explosion */
-        couleurs_actives = 1;
+        for (int i = 1; i < PAIRE_NOMBRE; ++i) init_pair((short)i, couleurs_paires[i], COLOR_BLACK);
+        c->couleurs = 1;
     }
 
+    /* une fenêtre plein écran par écran ; les menus attendent leurs
+     * touches, le jeu les lit sans bloquer */
+    for (int i = 0; i < 2; ++i) {
+        c->fenetres[i] = newwin(LINES, COLS, 0, 0);
+        if (!c->fenetres[i]) {
+            vue_console_fermer(c);
+            return NULL;
+        }
+        keypad(c->fenetres[i], TRUE);
+    }
+    nodelay(c->fenetres[ECRAN_JEU], TRUE);
+
+    /* ncurses (6.4) vide sa sortie à chaque déplacement du curseur tant
+     * qu'endwin() n'a jamais été appelé : une suspension avant la première
+     * image, reprise au premier doupdate, fait partir chaque image en un
+     * seul write() */
+    def_prog_mode();
+    endwin();
+
+    /* les rapports imprimés pendant la session abîmeraient l'écran */
+    c->rapports = tmpfile();
+    return c;
+}
+
+void vue_console_fermer(ContexteConsole* c) {
+    if (!c) return;
+    for (int i = 0; i < 2; ++i) {
+        if (c->fenetres[i]) delwin(c->fenetres[i]);
+    }
+    endwin();
+    if (c->rapports) {
+        char ligne[256];
+        rewind(c->rapports);
+        while (fgets(ligne, sizeof(ligne), c->rapports)) fputs(ligne, stderr);
+        fclose(c->rapports);
+    }
+    free(c);
+}
+
+WINDOW* vue_console_ecran(ContexteConsole* c, int ecran) {
+    WINDOW* fenetre = c->fenetres[ecran];
+    /* la fenêtre recouvre celle de l'écran précédent : toutes ses lignes
+     * repartent au prochain wnoutrefresh, doupdate ne garde que la différence */
+    touchwin(fenetre);
+    return fenetre;
+}
+
+attr_t vue_console_couleur(const ContexteConsole* c, int paire) {
+    return (c && c->couleurs) ? (attr_t)COLOR_PAIR(paire) : A_NORMAL;
+}
+
+void vue_console_publier(ContexteConsole* c, WINDOW* fenetre) {
+    (void)c;
+    wnoutrefresh(fenetre);
+    doupdate();
+}
+
+/* Caractère et attribut de chaque code CASE_* du calque ; les attributs
+ * sont calculés une fois, selon que le terminal a des couleurs */
+static const char glyphes[CASE_NOMBRE_CODES] = { ' ', 'W', '|', '!', '#', '*', '^', 'W' };
+static const short paires[CASE_NOMBRE_CODES] = {
+    PAIRE_TEXTE, PAIRE_ENNEMI, PAIRE_TIR, PAIRE_TIR_ENNEMI, PAIRE_BOUCLIER, PAIRE_PARTICULE, PAIRE_VAISSEAU,
+    PAIRE_ENNEMI
+};
+static attr_t attributs[CASE_NOMBRE_CODES];
+
+static void preparer_attributs(const ContexteConsole* c) {
+    for (int i = 0; i < CASE_NOMBRE_CODES; ++i)
+        attributs[i] = c->couleurs ? (vue_console_couleur(c, paires[i]) | A_BOLD) : A_NORMAL;
+}
+
+/* Dessine `n` cases du calque à partir de (ligne, colonne) de l'écran : les
+ * cases voisines de même attribut partent en une seule chaîne */
+static void dessiner_cases(WINDOW* fenetre, const uint8_t* codes, int ligne, int colonne, int n) {
+    char texte[256];
+    int i = 0;
+    while (i < n) {
+        int code = codes[i] < CASE_NOMBRE_CODES ? codes[i] : CASE_VIDE;
+        attr_t attr = attributs[code];
+        int debut = i, longueur = 0;
+        while (i < n && longueur < (int)sizeof(texte)) {
+            code = codes[i] < CASE_NOMBRE_CODES ? codes[i] : CASE_VIDE;
+            if (attributs[code] != attr) break;
+            texte[longueur++] = glyphes[code];
+            ++i;
+        }
+        wattrset(fenetre, attr);
+        mvwaddnstr(fenetre, ligne, colonne + debut, texte, longueur);
+    }
+    wattrset(fenetre, A_NORMAL);
+}
+
+/* Rendu console basé sur ncursesw. Touches : 'a'/'LEFT' gauche, 'd'/'RIGHT' droite,
+ * 'espace' tirer, 'p' pause, 'q' quitter
+ */
+int vue_console_executer(ContexteConsole* c, EtatJeu* e) {
+    if (!c || !e) return -1;
+
+    WINDOW* w = vue_console_ecran(c, ECRAN_JEU);
+    preparer_attributs(c);
+    const attr_t texte = vue_console_couleur(c, PAIRE_TEXTE) | A_BOLD;
+
     int hauteur_term = 0, largeur_term = 0;
-    getmaxyx(stdscr, hauteur_term, largeur_term);
-    (void)largeur_term;
+    getmaxyx(w, hauteur_term, largeur_term);
 
+    /* seule la partie du terrain qui tient dans le terminal (sous la ligne
+     * de score) est dessinée */
     const int largeur = etatjeu_obtenir_largeur(e);
-    int hauteur = hauteur_term - 2;
-    if (hauteur <= 0) hauteur = 24;
+    const int hauteur = etatjeu_obtenir_hauteur(e);
+    int lignes_visibles = hauteur_term - 2;
+    if (lignes_visibles > hauteur) lignes_visibles = hauteur;
+    if (lignes_visibles < 1) lignes_visibles = 1;
+    int colonnes_visibles = largeur_term < largeur ? largeur_term : largeur;
 
-    const int ips = 20;
-    const int temps_image_ms = 1000 / ips;
+    /* 20 images par seconde, à échéances fixes ; la simulation avance en
+     * ticks fixes (PAS_FIXE) selon le temps réellement écoulé, soit environ
+     * 3 ticks par image */
+    Cadence cadence;
+    cadence_demarrer(&cadence, 20);
+    uint64_t instant_prec = horloge_ns();
     int en_pause = 0;
+    EntreesTick entrees = { 0 };
 
-    int prev_score = -1, prev_vies = -1, prev_niveau = -1;
+    /* la ligne de score n'est redessinée que si un événement du modèle la
+     * change (ennemi tué, vaisseau touché, nouvelle vague) */
+    CurseurEvenements curseur;
+    etatjeu_evenements_suivre(e, &curseur);
+    Evenement evenements[64];
+    int entete_change = 1;
     int prev_pause = -1;
 
-    /* buffer d'écran */
-    char* tampon = malloc((size_t)largeur * hauteur);
-    char* tampon_prev = malloc((size_t)largeur * hauteur);
-    if (!tampon || !tampon_prev) { free(tampon); free(tampon_prev); endwin(); return -1; }
-    memset(tampon_prev, 0, (size_t)largeur * hauteur);
+    /* le calque du modèle remplace le tampon d'écran : seules les cases
+     * qu'il marque comme modifiées sont redessinées ; tout l'écran l'est à
+     * la première image et après l'écran de game over */
+    if (etatjeu_calque_actualiser(e) < 0) return -1;
+    int tout_redessiner = 1;
 
     while (!etatjeu_devrait_quitter(e)) {
         /* Si game over, afficher message et attendre choix */
         if (etatjeu_est_game_over(e)) {
-            clear();
-            if (couleurs_actives) attron(COLOR_PAIR(1) | A_BOLD);
-            else attron(A_BOLD);
-            mvprintw(hauteur / 2 - 2, largeur / 2 - 10, "VOUS ETES MORT !");
-            mvprintw(hauteur / 2, largeur / 2 - 15, "Score final: %d", etatjeu_obtenir_score(e));
-            mvprintw(hauteur / 2 + 2, largeur / 2 - 20, "Appuyez sur 'r' pour recommencer");
-            mvprintw(hauteur / 2 + 3, largeur / 2 - 20, "Appuyez sur 'q' pour quitter");
-            if (couleurs_actives) attroff(COLOR_PAIR(1) | A_BOLD);
-            else attroff(A_BOLD);
-            refresh();
+            werase(w);
+            tout_redessiner = 1; /* le message recouvre le terrain */
+            wattron(w, vue_console_couleur(c, PAIRE_ENNEMI) | A_BOLD);
+            mvwprintw(w, lignes_visibles / 2 - 2, colonnes_visibles / 2 - 10, "VOUS ETES MORT !");
+            mvwprintw(w, lignes_visibles / 2, colonnes_visibles / 2 - 15, "Score final: %d", etatjeu_obtenir_score(e));
+            mvwprintw(w, lignes_visibles / 2 + 2, colonnes_visibles / 2 - 20, "Appuyez sur 'r' pour recommencer");
+            mvwprintw(w, lignes_visibles / 2 + 3, colonnes_visibles / 2 - 20, "Appuyez sur 'q' pour quitter");
+            wattroff(w, vue_console_couleur(c, PAIRE_ENNEMI) | A_BOLD);
+            vue_console_publier(c, w);
             
             /* Attendre choix */
-            nodelay(stdscr, FALSE); /* Bloquer pour attendre la touche */
-            int choix = getch();
-            nodelay(stdscr, TRUE); /* Revenir en mode non-bloquant */
+            nodelay(w, FALSE); /* Bloquer pour attendre la touche */
+            int choix = wgetch(w);
+            nodelay(w, TRUE); /* Revenir en mode non-bloquant */
             
             if (choix == 'r' || choix == 'R') {
-                etatjeu_reinitialiser(e);
+                controleur_appliquer_commande(e, CMD_RECOMMENCER);
                 en_pause = 0;
+                controleur_entrees_vider(&entrees);
+                entete_change = 1; /* score, vies et niveau repartent de zéro */
+                instant_prec = horloge_ns(); /* l'attente de la touche ne compte pas */
+                cadence_recaler(&cadence);
                 continue;
             } else if (choix == 'q' || choix == 'Q') {
                 controleur_appliquer_commande(e, CMD_QUITTER);
@@ -108,127 +235,86 @@ int vue_console_executer(EtatJeu* e) {
             }
         }
         
-        int touche = lire_touche_non_bloquant();
-        int input_recu = (touche != -1);
-        if (input_recu) {
-            if (touche == g_bindings.quitter || touche == toupper(g_bindings.quitter)) { controleur_appliquer_commande(e, CMD_QUITTER); break; }
-            if (touche == g_bindings.pause || touche == toupper(g_bindings.pause)) { en_pause = !en_pause; }
-            if (touche == g_bindings.gauche || touche == toupper(g_bindings.gauche) || touche == KEY_LEFT) controleur_appliquer_commande(e, CMD_GAUCHE);
-            if (touche == g_bindings.droite || touche == toupper(g_bindings.droite) || touche == KEY_RIGHT) controleur_appliquer_commande(e, CMD_DROITE);
-            if (touche == g_bindings.tirer || touche == toupper(g_bindings.tirer) || touche == KEY_ENTER || touche == '\n' || touche == '\r') controleur_appliquer_commande(e, CMD_TIRER);
+        /* toutes les touches en attente sont lues : le terminal n'envoie pas
+         * de relâchement, une touche lue pendant l'image (répétition
+         * automatique comprise) compte comme maintenue */
+        unsigned vues = 0;
+        int quitter = 0;
+        int touche;
+        while ((touche = lire_touche_non_bloquant(w)) != -1) {
+            if (touche == g_bindings.quitter || touche == toupper(g_bindings.quitter)) quitter = 1;
+            if (touche == g_bindings.pause || touche == toupper(g_bindings.pause)) vues |= ENTREE_PAUSE;
+            if (touche == g_bindings.gauche || touche == toupper(g_bindings.gauche) || touche == KEY_LEFT) vues |= ENTREE_GAUCHE;
+            if (touche == g_bindings.droite || touche == toupper(g_bindings.droite) || touche == KEY_RIGHT) vues |= ENTREE_DROITE;
+            if (touche == g_bindings.tirer || touche == toupper(g_bindings.tirer) || touche == KEY_ENTER || touche == '\n' || touche == '\r') vues |= ENTREE_TIRER;
         }
+        if (quitter) { controleur_appliquer_commande(e, CMD_QUITTER); break; }
+        controleur_entrees_image(&entrees, vues);
+        if (entrees.appuyees & ENTREE_PAUSE) en_pause = !en_pause;
 
-        if (!en_pause) etatjeu_mettre_a_jour(e, 1.0 / ips);
-
-        /* effacer le buffer */
-        memset(tampon, ' ', (size_t)largeur * hauteur);
+        uint64_t maintenant = horloge_ns();
+        double dt_reel = (double)(maintenant - instant_prec) / 1e9;
+        instant_prec = maintenant;
+        if (!en_pause) controleur_avancer(e, &entrees, dt_reel);
+        else controleur_entrees_vider(&entrees);
 
-        /* dessiner les ennemis */
-        int nombre_ennemis = etatjeu_obtenir_nombre_ennemis(e);
-        for (int idx = 0; idx < nombre_ennemis; ++idx) {
-            if (!etatjeu_ennemi_vivant(e, idx)) continue;
-            int ennemi_x = etatjeu_obtenir_ennemi_x(e, idx);
-            int ennemi_y = etatjeu_obtenir_ennemi_y(e, idx);
-            if (ennemi_y >= 0 && ennemi_y < hauteur && ennemi_x >= 0 && ennemi_x < largeur) tampon[ennemi_y * largeur + ennemi_x] = 'W';
-        }
-
-        /* dessiner les projectiles */
-        int nombre_projectiles = etatjeu_obtenir_nombre_projectiles(e);
-        for (int idx = 0; idx < nombre_projectiles; ++idx) {
-            int proj_x = etatjeu_obtenir_projectile_x(e, idx);
-            int proj_y = etatjeu_obtenir_projectile_y(e, idx);
-            int proprietaire = etatjeu_obtenir_projectile_proprietaire(e, idx);
-            if (proj_y >= 0 && proj_y < hauteur && proj_x >= 0 && proj_x < largeur) tampon[proj_y * largeur + proj_x] = proprietaire == 0 ? '|' : '!';
-        }
+        if (etatjeu_calque_actualiser(e) < 0) break;
+        const uint8_t* calque = etatjeu_calque(e);
 
-        /* dessiner les boucliers */
-        int nombre_boucliers = etatjeu_obtenir_nombre_boucliers(e);
-        for (int idx = 0; idx < nombre_boucliers; ++idx) {
-            if (!etatjeu_bouclier_vivant(e, idx)) continue;
-            int bouclier_x = etatjeu_obtenir_bouclier_x(e, idx);
-            int bouclier_y = etatjeu_obtenir_bouclier_y(e, idx);
-            if (bouclier_y >= 0 && bouclier_y < hauteur && bouclier_x >= 0 && bouclier_x < largeur) tampon[bouclier_y * largeur + bouclier_x] = '#';
+        int n;
+        while ((n = etatjeu_evenements_lire(e, &curseur, evenements, 64)) > 0) {
+            for (int i = 0; i < n; ++i) {
+                if (evenements[i].type == EVT_ENNEMI_TUE || evenements[i].type == EVT_JOUEUR_TOUCHE ||
+                    evenements[i].type == EVT_VAGUE_TERMINEE) entete_change = 1;
+            }
         }
-
-        /* dessiner les particules d'explosion */
-        int nombre_particules = etatjeu_obtenir_nombre_particules(e);
-        for (int idx = 0; idx < nombre_particules; ++idx) {
-            int part_x = etatjeu_obtenir_particule_x(e, idx);
-            int part_y = etatjeu_obtenir_particule_y(e, idx);
-            if (part_y >= 0 && part_y < hauteur && part_x >= 0 && part_x < largeur) tampon[part_y * largeur + part_x] = '*';
+        if (curseur.perdus > 0) {
+            entete_change = 1;
+            curseur.perdus = 0;
         }
 
-        /* dessiner le vaisseau */
-        int vaisseau_x = etatjeu_obtenir_vaisseau_x(e);
-        int vaisseau_y = hauteur - 2;
-        if (vaisseau_y >= 0 && vaisseau_y < hauteur && vaisseau_x >= 0 && vaisseau_x < largeur) tampon[vaisseau_y * largeur + vaisseau_x] = '^';
-
-        int score_actuel = etatjeu_obtenir_score(e);
-        int vies_actuelles = etatjeu_obtenir_vies(e);
-        int niveau_actuel = etatjeu_obtenir_niveau(e);
-
-        int contenu_change = memcmp(tampon, tampon_prev, (size_t)largeur * hauteur) != 0;
-        int header_change = (score_actuel != prev_score) || (vies_actuelles != prev_vies) || (niveau_actuel != prev_niveau);
         int pause_change = (en_pause != prev_pause);
 
-        if (input_recu || contenu_change || header_change || pause_change) {
-            clear();
-            if (couleurs_actives) {
-                attron(COLOR_PAIR(5) | A_BOLD);
-                mvprintw(0, 0, "Score: %d  Vies: %d  Level: %d", score_actuel, vies_actuelles, niveau_actuel);
-                attroff(COLOR_PAIR(5) | A_BOLD);
-            } else {
-                attron(A_BOLD);
-                mvprintw(0, 0, "Score: %d  Vies: %d  Level: %d", score_actuel, vies_actuelles, niveau_actuel);
-                attroff(A_BOLD);
-            }
-            for (int lig = 0; lig < hauteur; ++lig) {
-                for (int col = 0; col < largeur; ++col) {
-                    int caractere = tampon[lig * largeur + col];
-                    if (couleurs_actives) {
-                        if (caractere == 'W') attron(COLOR_PAIR(1) | A_BOLD);
-                        else if (caractere == '^') attron(COLOR_PAIR(2) | A_BOLD);
-                        else if (caractere == '|') attron(COLOR_PAIR(3) | A_BOLD);
-                        else if (caractere == '!') attron(COLOR_PAIR(4) | A_BOLD);
-                        else if (caractere == '#') attron(COLOR_PAIR(6) | A_BOLD);
-                        else if (caractere == '*') attron(COLOR_PAIR(7) | A_BOLD);
-                        else attron(COLOR_PAIR(5) | A_BOLD);
-                    }
-                    mvaddch(lig + 1, col, caractere);
-                    if (couleurs_actives) {
-                        if (caractere == 'W') attroff(COLOR_PAIR(1) | A_BOLD);
-                        else if (caractere == '^') attroff(COLOR_PAIR(2) | A_BOLD);
-                        else if (caractere == '|') attroff(COLOR_PAIR(3) | A_BOLD);
-                        else if (caractere == '!') attroff(COLOR_PAIR(4) | A_BOLD);
-                        else if (caractere == '#') attroff(COLOR_PAIR(6) | A_BOLD);
-                        else if (caractere == '*') attroff(COLOR_PAIR(7) | A_BOLD);
-                        else if (caractere == '#') attroff(COLOR_PAIR(6) | A_BOLD);
-                        else attroff(COLOR_PAIR(5) | A_BOLD);
-                    }
-                }
+        if (tout_redessiner) {
+            werase(w);
+            for (int lig = 0; lig < lignes_visibles; ++lig) dessiner_cases(w, calque + (size_t)lig * largeur, lig + 1, 0, colonnes_visibles);
+            entete_change = 1;
+            pause_change = 1;
+        } else {
+            CurseurPlages plages = { 0, 0 };
+            PlageModifiee plage;
+            while (etatjeu_plage_suivante(e, &plages, &plage) && plage.y < lignes_visibles) {
+                int x1 = plage.x1 < colonnes_visibles ? plage.x1 : colonnes_visibles;
+                if (plage.x0 < x1) dessiner_cases(w, calque + (size_t)plage.y * largeur + plage.x0, plage.y + 1, plage.x0, x1 - plage.x0);
             }
+        }
+        etatjeu_calque_acquitter(e);
 
+        if (entete_change) {
+            wmove(w, 0, 0);
+            wclrtoeol(w);
+            wattron(w, texte);
+            mvwprintw(w, 0, 0, "Score: %d  Vies: %d  Level: %d", etatjeu_obtenir_score(e), etatjeu_obtenir_vies(e), etatjeu_obtenir_niveau(e));
+            wattroff(w, texte);
+        }
+        if (pause_change) {
+            wmove(w, lignes_visibles + 1, 0);
+            wclrtoeol(w);
             if (en_pause) {
-                if (couleurs_actives) attron(COLOR_PAIR(5) | A_BOLD);
-                else attron(A_BOLD);
-                mvprintw(hauteur + 1, 0, "-- EN PAUSE --");
-                if (couleurs_actives) attroff(COLOR_PAIR(5) | A_BOLD);
-                else attroff(A_BOLD);
+                wattron(w, texte);
+                mvwprintw(w, lignes_visibles + 1, 0, "-- EN PAUSE --");
+                wattroff(w, texte);
             }
-
-            refresh();
-            memcpy(tampon_prev, tampon, (size_t)largeur * hauteur);
-            prev_score = score_actuel;
-            prev_vies = vies_actuelles;
-            prev_niveau = niveau_actuel;
-            prev_pause = en_pause;
         }
+        /* curses n'envoie au terminal que les cases réellement changées */
+        vue_console_publier(c, w);
+        tout_redessiner = 0;
+        entete_change = 0;
+        prev_pause = en_pause;
 
-        napms(temps_image_ms);
+        cadence_attendre(&cadence);
     }
 
-    free(tampon);
-    free(tampon_prev);
-    endwin();
+    cadence_rapport(&cadence, "console", c->rapports ? c->rapports : stderr);
     return 0;
 }
@@ -0,0 +1,333 @@
+/*
+ * view_headless.c
+ * ---------------
+ * Vue sans affichage : enchaîne les ticks du modèle le plus vite possible
+ * en pilotant le contrôleur avec une politique automatique. Sert de banc
+ * de mesure reproductible pour `model.c`.
+ */
+
+#include "view_headless.h"
+#include "controller.h"
+#include "model_noyaux.h"
+#include "rejeu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void vue_headless_config_defaut(ConfigHeadless* c) {
+    if (!c) return;
+    c->ticks_max = 100000;
+    c->parties_max = 0;
+    c->politique = POLITIQUE_ALEATOIRE;
+    c->script = NULL;
+    c->graine = 1;
+    etatjeu_config_defaut(&c->jeu);
+    c->enregistrement = NULL;
+    c->intervalle_images = REJEU_INTERVALLE_DEFAUT;
+}
+
+static void afficher_rapport(const ConfigHeadless* c, long ticks, long parties, uint64_t duree_ns,
+                             const HistogrammeLatence* h, const long* evenements) {
+    double secondes = (double)duree_ns / 1e9;
+    if (secondes <= 0.0) secondes = 1e-9;
+    printf("=== Simulation headless ===\n");
+    static const char* const noms_tir[] = { "random", "aimed", "burst", "cycle" };
+    printf("terrain     : %d x %d  vague %d x %d  capacites %d/%d/%d  tir %s\n", c->jeu.largeur, c->jeu.hauteur,
+           c->jeu.vague_lignes, c->jeu.vague_colonnes, c->jeu.max_ennemis, c->jeu.max_projectiles, c->jeu.max_particules,
+           noms_tir[c->jeu.politique_tir]);
+    printf("ticks       : %ld\n", ticks);
+    printf("parties     : %ld\n", parties);
+    printf("pas fixe    : %.6f s\n", PAS_FIXE);
+    printf("duree       : %.3f s\n", secondes);
+    printf("ticks/s     : %.0f\n", (double)ticks / secondes);
+    printf("parties/s   : %.2f\n", (double)parties / secondes);
+    printf("latence par tick (ns) :\n");
+    printf("  min %llu  p50 %llu  p90 %llu  p99 %llu  p99.9 %llu  max %llu  moyenne %.1f\n",
+           (unsigned long long)(h->nombre ? h->min : 0),
+           (unsigned long long)histo_percentile(h, 0.50),
+           (unsigned long long)histo_percentile(h, 0.90),
+           (unsigned long long)histo_percentile(h, 0.99),
+           (unsigned long long)histo_percentile(h, 0.999),
+           (unsigned long long)h->max,
+           h->nombre ? h->somme / (double)h->nombre : 0.0);
+    printf("evenements  : %ld ennemis tues, %ld boucliers touches, %ld vaisseau touche, %ld vagues, %ld game over\n",
+           evenements[EVT_ENNEMI_TUE], evenements[EVT_BOUCLIER_TOUCHE], evenements[EVT_JOUEUR_TOUCHE],
+           evenements[EVT_VAGUE_TERMINEE], evenements[EVT_GAME_OVER]);
+}
+
+int vue_headless_executer(const ConfigHeadless* c) {
+    if (!c || (c->ticks_max <= 0 && c->parties_max <= 0)) {
+        fprintf(stderr, "Configuration headless invalide (--ticks ou --games requis)\n");
+        return 1;
+    }
+
+    EtatJeu* e = etatjeu_creer_config(&c->jeu, c->graine);
+    if (!e) {
+        fprintf(stderr, "Échec de création de l'état du jeu\n");
+        return 1;
+    }
+
+    PolitiqueEntree politique;
+    politique_initialiser(&politique, c->politique, c->script, c->graine);
+
+    /* --record : les commandes de la politique passent par le contrôleur, qui les écrit */
+    Enregistreur* enregistreur = NULL;
+    if (c->enregistrement) {
+        enregistreur = rejeu_enregistrer_ouvrir(c->enregistrement, e, c->intervalle_images);
+        if (!enregistreur) {
+            fprintf(stderr, "Impossible de créer le fichier de rejeu '%s'\n", c->enregistrement);
+            etatjeu_detruire(e);
+            return 1;
+        }
+        controleur_definir_enregistreur(enregistreur, e);
+    }
+
+    HistogrammeLatence histo;
+    histo_initialiser(&histo);
+
+    /* télémétrie : les événements sont comptés entre deux ticks, hors mesure */
+    CurseurEvenements curseur;
+    etatjeu_evenements_suivre(e, &curseur);
+    Evenement lus[64];
+    long evenements[EVT_NOMBRE_TYPES] = { 0 };
+
+    long ticks = 0;
+    long parties = 0;
+    uint64_t debut = horloge_ns();
+
+    while ((c->ticks_max <= 0 || ticks < c->ticks_max) &&
+           (c->parties_max <= 0 || parties < c->parties_max)) {
+        uint64_t t0 = horloge_ns();
+        politique_appliquer(&politique, e);
+        etatjeu_tick(e);
+        uint64_t t1 = horloge_ns();
+        histo_ajouter(&histo, t1 - t0);
+        ++ticks;
+
+        int n;
+        while ((n = etatjeu_evenements_lire(e, &curseur, lus, 64)) > 0) {
+            for (int i = 0; i < n; ++i) evenements[lus[i].type] += 1;
+        }
+
+        /* partie terminée : on repart immédiatement sur une nouvelle */
+        if (etatjeu_est_game_over(e) || etatjeu_devrait_quitter(e)) {
+            ++parties;
+            controleur_appliquer_commande(e, CMD_RECOMMENCER);
+        }
+    }
+
+    uint64_t duree = horloge_ns() - debut;
+    if (enregistreur) {
+        controleur_definir_enregistreur(NULL, NULL);
+        if (rejeu_enregistrer_fermer(enregistreur, e) != 0)
+            fprintf(stderr, "Écriture incomplète du fichier de rejeu '%s'\n", c->enregistrement);
+    }
+    afficher_rapport(c, ticks, parties, duree, &histo, evenements);
+    if (curseur.perdus > 0) printf("(%llu evenements perdus : plus de %d en un tick)\n",
+                                   (unsigned long long)curseur.perdus, EVENEMENTS_CAPACITE);
+
+    etatjeu_detruire(e);
+    return 0;
+}
+
+/* Valeurs initiales pseudo-aléatoires mais reproductibles pour le banc des noyaux */
+static void remplir_entites(int16_t* x, int16_t* y, int16_t* vx, int16_t* vy, int16_t* ttl,
+                            uint8_t* vivant, int n) {
+    uint32_t r = 12345u;
+    for (int i = 0; i < n; ++i) {
+        r = r * 1664525u + 1013904223u;
+        x[i] = (int16_t)((r >> 8) % 80);
+        y[i] = (int16_t)((r >> 16) % 24);
+        vx[i] = (int16_t)((int)((r >> 4) % 3) - 1);
+        vy[i] = (int16_t)((int)((r >> 6) % 3) - 1);
+        ttl[i] = (int16_t)(1 + (r >> 20) % 20);
+        vivant[i] = (r & 3u) ? MASQUE_VIVANT : 0; /* ~75 % d'entités vivantes */
+    }
+}
+
+int vue_headless_noyaux(int n, long iterations) {
+    if (n <= 0 || iterations <= 0) {
+        fprintf(stderr, "Configuration du banc des noyaux invalide\n");
+        return 1;
+    }
+
+    size_t t16 = (size_t)n * sizeof(int16_t);
+    int16_t* x = (int16_t*)malloc(t16);
+    int16_t* y = (int16_t*)malloc(t16);
+    int16_t* vx = (int16_t*)malloc(t16);
+    int16_t* vy = (int16_t*)malloc(t16);
+    int16_t* ttl = (int16_t*)malloc(t16);
+    uint8_t* vivant = (uint8_t*)malloc((size_t)n);
+    if (!x || !y || !vx || !vy || !ttl || !vivant) {
+        fprintf(stderr, "Échec d'allocation du banc des noyaux\n");
+        free(x); free(y); free(vx); free(vy); free(ttl); free(vivant);
+        return 1;
+    }
+
+    printf("=== Banc des noyaux (%s) ===\n", noyau_variante());
+    printf("entites : %d  iterations : %ld\n", n, iterations);
+    printf("%-22s %12s %12s\n", "noyau", "ns/appel", "ns/entite");
+
+    /* Chaque mesure repart du même état pour que les variantes soient comparables. */
+    for (int k = 0; k < 2; ++k) {
+        remplir_entites(x, y, vx, vy, ttl, vivant, n);
+        /* projectiles : vitesses alternées (vy puis -vy) pour que la population
+         * active reste stable au lieu de sortir entièrement du terrain */
+        if (k == 1) for (int i = 0; i < n; ++i) ttl[i] = (int16_t)-vy[i];
+        uint64_t debut = horloge_ns();
+        for (long it = 0; it < iterations; ++it) {
+            if (k == 0) noyau_avancer_particules(x, y, vx, vy, ttl, n);
+            else noyau_avancer_projectiles(y, (it & 1) ? ttl : vy, vivant, n, 24);
+        }
+        double ns = (double)(horloge_ns() - debut) / (double)iterations;
+        static const char* noms[] = { "avancer_particules", "avancer_projectiles" };
+        printf("%-22s %12.1f %12.3f\n", noms[k], ns, ns / n);
+    }
+
+    free(x); free(y); free(vx); free(vy); free(ttl); free(vivant);
+    return 0;
+}
+
+int vue_headless_collisions(int n, long iterations) {
+    if (n <= 0 || n > CONFIG_CAPACITE_MAX || iterations <= 0) {
+        fprintf(stderr, "Configuration du banc de collisions invalide (1 <= N <= %d)\n", CONFIG_CAPACITE_MAX);
+        return 1;
+    }
+    /* terrain de 128 x 64 cases, agrandi tant qu'il ne peut pas loger N ennemis */
+    int largeur = 128, hauteur = 64;
+    while (largeur * hauteur < n) { largeur *= 2; hauteur *= 2; }
+    int cases = largeur * hauteur;
+
+    size_t t16 = (size_t)n * sizeof(int16_t);
+    int16_t* ex = (int16_t*)malloc(t16);
+    int16_t* ey = (int16_t*)malloc(t16);
+    int16_t* px = (int16_t*)malloc(t16);
+    int16_t* py = (int16_t*)malloc(t16);
+    uint8_t* vivant = (uint8_t*)malloc((size_t)n);
+    uint32_t* indice = (uint32_t*)malloc((size_t)cases * sizeof(uint32_t));
+    uint64_t* bits = (uint64_t*)malloc(grille_nombre_mots(largeur, hauteur) * sizeof(uint64_t));
+    if (!ex || !ey || !px || !py || !vivant || !indice || !bits) {
+        fprintf(stderr, "Échec d'allocation du banc de collisions\n");
+        free(ex); free(ey); free(px); free(py); free(vivant); free(indice); free(bits);
+        return 1;
+    }
+    Grille g;
+    grille_lier(&g, bits, largeur, hauteur);
+    Grille* grille = &g;
+
+    /* N ennemis sur des cases distinctes (parcours de la grille avec un pas
+     * premier avec le nombre de cases) et N tirs au hasard */
+    uint32_t r = 2024u;
+    for (int i = 0; i < n; ++i) {
+        int c = (int)(((long)i * 4099) % cases);
+        ex[i] = (int16_t)(c % largeur);
+        ey[i] = (int16_t)(c / largeur);
+        vivant[i] = MASQUE_VIVANT;
+        grille_poser(grille, ex[i], ey[i]);
+        indice[c] = (uint32_t)i;
+        r = r * 1664525u + 1013904223u;
+        px[i] = (int16_t)((r >> 8) % (uint32_t)largeur);
+        py[i] = (int16_t)((r >> 16) % (uint32_t)hauteur);
+    }
+
+    printf("=== Banc de collisions ===\n");
+    printf("terrain : %d x %d  ennemis : %d  tirs : %d  passes : %ld\n", largeur, hauteur, n, n, iterations);
+
+    /* boucles imbriquées : chaque tir comparé à chaque ennemi */
+    long touches_boucles = 0;
+    uint64_t debut = horloge_ns();
+    for (long it = 0; it < iterations; ++it) {
+        for (int p = 0; p < n; ++p) {
+            for (int k = 0; k < n; ++k) {
+                if (vivant[k] && ex[k] == px[p] && ey[k] == py[p]) {
+                    touches_boucles += k + 1;
+                    break;
+                }
+            }
+        }
+    }
+    double ns_boucles = (double)(horloge_ns() - debut) / (double)iterations;
+
+    /* grille : un bit testé par tir, puis l'indice de l'ennemi */
+    long touches_grille = 0;
+    debut = horloge_ns();
+    for (long it = 0; it < iterations; ++it) {
+        for (int p = 0; p < n; ++p) {
+            if (grille_occupee(grille, px[p], py[p]))
+                touches_grille += indice[py[p] * largeur + px[p]] + 1;
+        }
+    }
+    double ns_grille = (double)(horloge_ns() - debut) / (double)iterations;
+
+    printf("%-18s %14s %12s\n", "methode", "ns/passe", "ns/tir");
+    printf("%-18s %14.1f %12.2f\n", "boucles", ns_boucles, ns_boucles / n);
+    printf("%-18s %14.1f %12.2f\n", "grille", ns_grille, ns_grille / n);
+    printf("acceleration : %.1fx  (resultats %s)\n", ns_grille > 0.0 ? ns_boucles / ns_grille : 0.0,
+           touches_boucles == touches_grille ? "identiques" : "DIFFERENTS");
+
+    free(ex); free(ey); free(px); free(py); free(vivant); free(indice); free(bits);
+    return touches_boucles == touches_grille ? 0 : 1;
+}
+
+int vue_headless_sauvegarde(const ConfigHeadless* c, long iterations) {
+    if (!c || iterations <= 0) {
+        fprintf(stderr, "Configuration du banc de sauvegarde invalide\n");
+        return 1;
+    }
+    EtatJeu* e = etatjeu_creer_config(&c->jeu, c->graine);
+    EtatJeu* copie = etatjeu_creer_config(&c->jeu, c->graine);
+    size_t capacite = e ? etatjeu_sauvegarde_taille_max(e) : 0;
+    unsigned char* blob = (unsigned char*)malloc(capacite);
+    unsigned char* verif = (unsigned char*)malloc(capacite);
+    if (!e || !copie || !blob || !verif) {
+        fprintf(stderr, "Échec d'allocation du banc de sauvegarde\n");
+        etatjeu_detruire(e); etatjeu_detruire(copie); free(blob); free(verif);
+        return 1;
+    }
+
+    /* état de milieu de partie : quelques secondes jouées par la politique */
+    PolitiqueEntree politique;
+    politique_initialiser(&politique, c->politique, c->script, c->graine);
+    for (int t = 0; t < 600 && !etatjeu_est_game_over(e); ++t) {
+        politique_appliquer(&politique, e);
+        etatjeu_tick(e);
+    }
+    size_t taille = etatjeu_sauver(e, blob, capacite);
+
+    printf("=== Banc de sauvegarde ===\n");
+    printf("terrain : %d x %d  vague %d x %d  iterations : %ld\n", c->jeu.largeur, c->jeu.hauteur,
+           c->jeu.vague_lignes, c->jeu.vague_colonnes, iterations);
+    printf("blob    : %zu octets (maximum %zu)\n", taille, capacite);
+    printf("%-16s %12s\n", "operation", "ns/appel");
+
+    long puits = 0;
+    for (int k = 0; k < 3; ++k) {
+        uint64_t debut = horloge_ns();
+        for (long it = 0; it < iterations; ++it) {
+            switch (k) {
+                case 0: etatjeu_reinitialiser(copie); break;
+                case 1: puits += (long)etatjeu_sauver(e, verif, capacite); break;
+                default: puits += etatjeu_restaurer(copie, blob, taille); break;
+            }
+        }
+        double ns = (double)(horloge_ns() - debut) / (double)iterations;
+        static const char* noms[] = { "reinitialiser", "sauver", "restaurer" };
+        printf("%-16s %12.1f\n", noms[k], ns);
+    }
+    if (puits == 42) printf("\n"); /* empêche l'élimination du calcul */
+
+    /* la copie restaurée doit évoluer exactement comme l'original */
+    int identiques = 1;
+    for (int t = 0; t < 1000 && identiques; ++t) {
+        etatjeu_tick(e);
+        etatjeu_tick(copie);
+        size_t ta = etatjeu_sauver(e, blob, capacite);
+        size_t tb = etatjeu_sauver(copie, verif, capacite);
+        identiques = ta == tb && memcmp(blob, verif, ta) == 0;
+    }
+    printf("1000 ticks apres restauration : %s\n", identiques ? "identiques" : "DIFFERENTS");
+
+    etatjeu_detruire(e); etatjeu_detruire(copie); free(blob); free(verif);
+    return identiques ? 0 : 1;
+}
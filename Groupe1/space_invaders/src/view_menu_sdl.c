@@ -27,10 +27,10 @@ static bool key_in_use(const KeyBindings* b, SDL_Keycode k, int ignore_index) {
     return false;
 }
 
-static int sdl_menu_simple(int mode_highscores, HighScoreList* list) {
-    if (!SDL_WasInit(SDL_INIT_VIDEO)) SDL_Init(SDL_INIT_VIDEO);
-    SDL_Window* win = SDL_CreateWindow("Space Invaders - Menu", 640, 480, SDL_WINDOW_RESIZABLE);
-    SDL_Renderer* r = SDL_CreateRenderer(win, NULL);
+static int sdl_menu_simple(ContexteSDL* c, int mode_highscores, HighScoreList* list) {
+    if (!c) return MENU_QUITTER;
+    vue_sdl_ecran(c, "Space Invaders - Menu", 640, 480);
+    SDL_Renderer* r = vue_sdl_rendu(c);
     int selection = 0;
     int running = 1;
     SDL_Color blanc = {255,255,255,255};
@@ -67,28 +67,27 @@ static int sdl_menu_simple(int mode_highscores, HighScoreList* list) {
             }
             bitmap_draw_text(r, 180, 200 + 5*40, "APPUYEZ SUR UNE TOUCHE", blanc);
         }
-        SDL_RenderPresent(r);
+        vue_sdl_presenter(c);
         SDL_Delay(16);
     }
-    SDL_DestroyRenderer(r); SDL_DestroyWindow(win);
     if (selection==1) return MENU_VOIR_HIGHSCORES;
     if (selection==2) return MENU_OPTIONS;
     if (selection==3) return MENU_QUITTER;
     return MENU_JOUER;
 }
 
-int vue_sdl_menu_principal(void) {
-    return sdl_menu_simple(0, NULL);
+int vue_sdl_menu_principal(ContexteSDL* c) {
+    return sdl_menu_simple(c, 0, NULL);
 }
 
-void vue_sdl_afficher_highscores(HighScoreList* list) {
-    (void)sdl_menu_simple(1, list);
+void vue_sdl_afficher_highscores(ContexteSDL* c, HighScoreList* list) {
+    (void)sdl_menu_simple(c, 1, list);
 }
 
-void vue_sdl_menu_options(void) {
-    if (!SDL_WasInit(SDL_INIT_VIDEO)) SDL_Init(SDL_INIT_VIDEO);
-    SDL_Window* win = SDL_CreateWindow("Options", 640, 480, SDL_WINDOW_RESIZABLE);
-    SDL_Renderer* r = SDL_CreateRenderer(win, NULL);
+void vue_sdl_menu_options(ContexteSDL* c) {
+    if (!c) return;
+    vue_sdl_ecran(c, "Options", 640, 480);
+    SDL_Renderer* r = vue_sdl_rendu(c);
 
     KeyBindings binds;
     vue_sdl_get_bindings(&binds);
@@ -113,7 +112,7 @@ void vue_sdl_menu_options(void) {
                     /* Demander une nouvelle touche */
                     SDL_SetRenderDrawColor(r, 0,0,0,255); SDL_RenderClear(r);
                     bitmap_draw_text(r, 120, 200, "APPUYEZ SUR UNE TOUCHE", blanc);
-                    SDL_RenderPresent(r);
+                    vue_sdl_presenter(c);
                     SDL_Event wait_evt;
                     while (SDL_WaitEvent(&wait_evt)) {
                         if (wait_evt.type == SDL_EVENT_KEY_DOWN) {
@@ -159,22 +158,25 @@ void vue_sdl_menu_options(void) {
             bitmap_draw_text(r, 120, 400, info, jaune);
         }
 
-        SDL_RenderPresent(r);
+        vue_sdl_presenter(c);
         SDL_Delay(16);
     }
 
     vue_sdl_set_bindings(&binds);
-    SDL_DestroyRenderer(r); SDL_DestroyWindow(win);
 }
 
-char* vue_sdl_saisir_nom(int score, HighScoreList* list) {
+char* vue_sdl_saisir_nom(ContexteSDL* c, int score, HighScoreList* list) {
     (void)list;
-    if (!SDL_WasInit(SDL_INIT_VIDEO)) SDL_Init(SDL_INIT_VIDEO);
-    SDL_Window* win = SDL_CreateWindow("Nouveau score", 640, 200, 0);
-    SDL_Renderer* r = SDL_CreateRenderer(win, NULL);
-    SDL_StartTextInput(win);
     char* nom = (char*)malloc(21);
     memset(nom, 0, 21);
+    if (!c) {
+        strcpy(nom, "ANONYME");
+        return nom;
+    }
+    vue_sdl_ecran(c, "Nouveau score", 640, 200);
+    SDL_Renderer* r = vue_sdl_rendu(c);
+    SDL_Window* win = vue_sdl_fenetre(c);
+    SDL_StartTextInput(win);
     SDL_Color blanc = {255,255,255,255};
     SDL_Color jaune = {255,200,0,255};
     int running = 1;
@@ -196,10 +198,9 @@ char* vue_sdl_saisir_nom(int score, HighScoreList* list) {
         bitmap_draw_text(r, 40, 80, ligne, blanc);
         bitmap_draw_text(r, 40, 120, "NOM:", blanc);
         bitmap_draw_text(r, 120, 120, nom[0]?nom:"_", jaune);
-        SDL_RenderPresent(r); SDL_Delay(16);
+        vue_sdl_presenter(c); SDL_Delay(16);
     }
     SDL_StopTextInput(win);
-    SDL_DestroyRenderer(r); SDL_DestroyWindow(win);
     if (strlen(nom)==0) strcpy(nom, "ANONYME");
     return nom;
 }
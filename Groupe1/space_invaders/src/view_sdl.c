@@ -9,6 +9,7 @@
 #include "view_sdl.h"
 #include "controller.h"
 #include "text_bitmap.h"
+#include "cadence.h"
 
 #include <SDL3/SDL.h>
 #include <stdio.h>
@@ -20,12 +21,18 @@
 #define HAUTEUR_FENETRE  600
 #define TAILLE_CELLULE   10
 
-/* Structure pour gérer l'état SDL */
-typedef struct {
+/* Contexte SDL partagé par tous les écrans (voir view_sdl.h) */
+struct ContexteSDL {
     SDL_Window* fenetre;
     SDL_Renderer* rendu;
-    int en_cours;
-} ContexteSDL;
+    int en_cours;          /* partie en cours (remis à 1 par vue_sdl_executer) */
+    int mode_rendu;        /* RENDU_SDL_* des parties */
+    int pixels_case;       /* RENDU_SDL_TEXTURE : côté d'une case en pixels de texture */
+    /* transitions : temps entre le début d'un écran et sa première image */
+    Uint64 debut_ecran;    /* 0 : première image déjà présentée */
+    Uint64 transition_total, transition_max;
+    int transitions;
+};
 
 static KeyBindings g_bindings = { SDLK_LEFT, SDLK_RIGHT, SDLK_SPACE, SDLK_P, SDLK_Q };
 
@@ -51,10 +58,11 @@ static void keycode_label(SDL_Keycode code, char* buf, size_t sz) {
     snprintf(buf, sz, "%s", name);
 }
 
-/* Initialise SDL et crée la fenêtre/rendu */
-static ContexteSDL* sdl_initialiser(void) {
-    ContexteSDL* contexte = (ContexteSDL*)malloc(sizeof(ContexteSDL));
+/* Initialise SDL et crée la fenêtre/rendu, une fois pour toute la session */
+ContexteSDL* vue_sdl_ouvrir(void) {
+    ContexteSDL* contexte = (ContexteSDL*)calloc(1, sizeof(ContexteSDL));
     if (!contexte) return NULL;
+    contexte->pixels_case = 1;
 
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         fprintf(stderr, "Erreur SDL_Init: %s\n", SDL_GetError());
@@ -87,6 +95,46 @@ static ContexteSDL* sdl_initialiser(void) {
     return contexte;
 }
 
+SDL_Renderer* vue_sdl_rendu(ContexteSDL* c) {
+    return c ? c->rendu : NULL;
+}
+
+SDL_Window* vue_sdl_fenetre(ContexteSDL* c) {
+    return c ? c->fenetre : NULL;
+}
+
+void vue_sdl_definir_rendu(ContexteSDL* c, int mode, int pixels_case) {
+    if (!c) return;
+    c->mode_rendu = mode == RENDU_SDL_TEXTURE ? RENDU_SDL_TEXTURE : RENDU_SDL_RECTANGLES;
+    if (pixels_case < 1) pixels_case = 1;
+    if (pixels_case > PIXELS_CASE_MAX) pixels_case = PIXELS_CASE_MAX;
+    c->pixels_case = pixels_case;
+}
+
+void vue_sdl_ecran(ContexteSDL* c, const char* titre, int largeur_logique, int hauteur_logique) {
+    if (!c) return;
+    c->debut_ecran = SDL_GetTicksNS();
+    if (c->debut_ecran == 0) c->debut_ecran = 1;
+    SDL_SetWindowTitle(c->fenetre, titre);
+    SDL_SetRenderLogicalPresentation(c->rendu, largeur_logique, hauteur_logique,
+                                     largeur_logique > 0 ? SDL_LOGICAL_PRESENTATION_LETTERBOX
+                                                         : SDL_LOGICAL_PRESENTATION_DISABLED);
+    /* la touche qui a fermé l'écran précédent ne doit pas agir sur celui-ci */
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+}
+
+void vue_sdl_presenter(ContexteSDL* c) {
+    if (!c) return;
+    SDL_RenderPresent(c->rendu);
+    if (c->debut_ecran) {
+        Uint64 duree = SDL_GetTicksNS() - c->debut_ecran;
+        c->transition_total += duree;
+        if (duree > c->transition_max) c->transition_max = duree;
+        c->transitions += 1;
+        c->debut_ecran = 0;
+    }
+}
+
 /* Affiche un menu pause simple et attend une action */
 static int afficher_pause(ContexteSDL* contexte, EtatJeu* e) {
     int continuer = 1;
@@ -110,7 +158,7 @@ static int afficher_pause(ContexteSDL* contexte, EtatJeu* e) {
         snprintf(quit_label, sizeof(quit_label), "%s POUR QUITTER", keyname);
         bitmap_draw_text(contexte->rendu, largeur_fenetre / 2 - 110, hauteur_fenetre / 2 + 20, quit_label, couleur_magenta_local);
 
-        SDL_RenderPresent(contexte->rendu);
+        vue_sdl_presenter(contexte);
 
         SDL_Event evt;
         if (SDL_WaitEvent(&evt)) {
@@ -131,10 +179,16 @@ static int afficher_pause(ContexteSDL* contexte, EtatJeu* e) {
     return 1;
 }
 
-/* Libère les ressources SDL */
-static void sdl_quitter(ContexteSDL* contexte) {
+/* Libère les ressources SDL, à la fin de la session */
+void vue_sdl_fermer(ContexteSDL* contexte) {
     if (!contexte) return;
+    if (contexte->transitions > 0) {
+        fprintf(stderr, "sdl : %d ecrans, premiere image en %.2f ms en moyenne, %.2f ms au plus\n",
+                contexte->transitions, (double)contexte->transition_total / contexte->transitions / 1e6,
+                (double)contexte->transition_max / 1e6);
+    }
     if (contexte->rendu) {
+        bitmap_font_release(contexte->rendu);
         SDL_DestroyRenderer(contexte->rendu);
         contexte->rendu = NULL;
     }
@@ -154,22 +208,145 @@ static void dessiner_rectangle(SDL_Renderer* rendu, int x, int y, int largeur, i
     SDL_RenderFillRect(rendu, &rect);
 }
 
-/* Traite les événements SDL et retourne 0 si quitter, 1 sinon */
-static int traiter_evenements(ContexteSDL* contexte, EtatJeu* e) {
+/*
+ * Lots de dessin d'une image : les rectangles du terrain sont rangés par
+ * couleur dans des tableaux alloués une fois, puis soumis en un seul
+ * `SDL_RenderFillRects` par couleur. Les particules, dont l'opacité varie
+ * avec le ttl, partent en un seul `SDL_RenderGeometry` à couleur par
+ * sommet. Le nombre d'appels de dessin ne dépend plus du nombre d'entités.
+ */
+enum { LOT_ROUGE, LOT_ORANGE, LOT_VERT, LOT_JAUNE, LOT_MAGENTA, LOT_CYAN, LOT_NOMBRE };
+#define LOT_VIES_MAX 32 /* petits carrés de vies dessinés au plus */
+
+typedef struct {
+    SDL_FRect* bloc;                /* un seul bloc, découpé en segments par couleur */
+    SDL_FRect* rects[LOT_NOMBRE];
+    int nb[LOT_NOMBRE], cap[LOT_NOMBRE];
+    SDL_Vertex* sommets;            /* 4 sommets par particule */
+    int* indices;                   /* 6 indices par particule, écrits une fois */
+    int nb_particules, cap_particules;
+} LotsImage;
+
+static void lots_liberer(LotsImage* l) {
+    free(l->bloc);
+    free(l->sommets);
+    free(l->indices);
+    memset(l, 0, sizeof(*l));
+}
+
+/* Dimensionne les lots sur les capacités de la capture.
+ * @return 0 si succès, 1 en cas d'échec (rien n'est alloué). */
+static int lots_allouer(LotsImage* l, const RenderSnapshot* capture) {
+    memset(l, 0, sizeof(*l));
+    l->cap[LOT_ROUGE] = capture->cap_ennemis;
+    l->cap[LOT_ORANGE] = capture->cap_ennemis;
+    l->cap[LOT_VERT] = capture->cap_boucliers;
+    l->cap[LOT_JAUNE] = capture->cap_projectiles;
+    l->cap[LOT_MAGENTA] = capture->cap_projectiles;
+    l->cap[LOT_CYAN] = 1 + LOT_VIES_MAX;
+    size_t total = 0;
+    for (int i = 0; i < LOT_NOMBRE; ++i) total += (size_t)l->cap[i];
+    l->cap_particules = capture->cap_particules;
+    l->bloc = (SDL_FRect*)malloc(sizeof(SDL_FRect) * total);
+    l->sommets = (SDL_Vertex*)malloc(sizeof(SDL_Vertex) * 4 * (size_t)(l->cap_particules + 1));
+    l->indices = (int*)malloc(sizeof(int) * 6 * (size_t)(l->cap_particules + 1));
+    if (!l->bloc || !l->sommets || !l->indices) {
+        lots_liberer(l);
+        return 1;
+    }
+    SDL_FRect* segment = l->bloc;
+    for (int i = 0; i < LOT_NOMBRE; ++i) {
+        l->rects[i] = segment;
+        segment += l->cap[i];
+    }
+    for (int p = 0; p < l->cap_particules; ++p) {
+        int* ind = l->indices + 6 * p;
+        int s = 4 * p;
+        ind[0] = s; ind[1] = s + 1; ind[2] = s + 2;
+        ind[3] = s + 2; ind[4] = s + 1; ind[5] = s + 3;
+    }
+    return 0;
+}
+
+static void lot_ajouter(LotsImage* l, int lot, int x, int y, int largeur, int hauteur) {
+    if (l->nb[lot] >= l->cap[lot]) return;
+    SDL_FRect* r = &l->rects[lot][l->nb[lot]++];
+    r->x = (float)x;
+    r->y = (float)y;
+    r->w = (float)largeur;
+    r->h = (float)hauteur;
+}
+
+static void lot_particule(LotsImage* l, int x, int y, int taille, SDL_Color c) {
+    if (l->nb_particules >= l->cap_particules) return;
+    SDL_Vertex* s = l->sommets + 4 * l->nb_particules++;
+    SDL_FColor couleur = { c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f };
+    float x0 = (float)x, y0 = (float)y, x1 = (float)(x + taille), y1 = (float)(y + taille);
+    s[0].position.x = x0; s[0].position.y = y0;
+    s[1].position.x = x1; s[1].position.y = y0;
+    s[2].position.x = x0; s[2].position.y = y1;
+    s[3].position.x = x1; s[3].position.y = y1;
+    for (int i = 0; i < 4; ++i) {
+        s[i].color = couleur;
+        s[i].tex_coord.x = 0.0f;
+        s[i].tex_coord.y = 0.0f;
+    }
+}
+
+static void lot_soumettre(SDL_Renderer* rendu, LotsImage* l, int lot, SDL_Color c) {
+    if (l->nb[lot] == 0) return;
+    SDL_SetRenderDrawColor(rendu, c.r, c.g, c.b, c.a);
+    SDL_RenderFillRects(rendu, l->rects[lot], l->nb[lot]);
+    l->nb[lot] = 0;
+}
+
+/* Soumet les lots dans l'ordre des couches (ennemis, boucliers, projectiles,
+ * particules, vaisseau et vies), puis les vide */
+static void lots_soumettre(SDL_Renderer* rendu, LotsImage* l) {
+    lot_soumettre(rendu, l, LOT_ROUGE, couleur_rouge);
+    lot_soumettre(rendu, l, LOT_ORANGE, couleur_orange);
+    lot_soumettre(rendu, l, LOT_VERT, couleur_vert);
+    lot_soumettre(rendu, l, LOT_JAUNE, couleur_jaune);
+    lot_soumettre(rendu, l, LOT_MAGENTA, couleur_magenta);
+    if (l->nb_particules > 0) {
+        SDL_SetRenderDrawBlendMode(rendu, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(rendu, NULL, l->sommets, 4 * l->nb_particules, l->indices, 6 * l->nb_particules);
+        SDL_SetRenderDrawBlendMode(rendu, SDL_BLENDMODE_NONE);
+        l->nb_particules = 0;
+    }
+    lot_soumettre(rendu, l, LOT_CYAN, couleur_cyan);
+}
+
+/* Bit ENTREE_* d'une touche de jeu (gauche, droite, tir), 0 pour les autres */
+static unsigned entree_touche(SDL_Keycode k) {
+    if (k == g_bindings.gauche || k == SDLK_LEFT || k == SDLK_A) return ENTREE_GAUCHE;
+    if (k == g_bindings.droite || k == SDLK_RIGHT || k == SDLK_D) return ENTREE_DROITE;
+    if (k == g_bindings.tirer || k == SDLK_SPACE) return ENTREE_TIRER;
+    return 0;
+}
+
+/* Traite les événements SDL et retourne 0 si quitter, 2 au retour d'une
+ * pause, 1 sinon. Vide la file d'événements dans `entrees` : l'appui et le
+ * relâchement donnent l'état maintenu exact, la répétition du système est
+ * ignorée (le contrôleur répète lui-même, à cadence fixe en ticks) */
+static int traiter_evenements(ContexteSDL* contexte, EtatJeu* e, EntreesTick* entrees) {
     SDL_Event evt;
     while (SDL_PollEvent(&evt)) {
         if (evt.type == SDL_EVENT_QUIT) return 0;
-        if (evt.type == SDL_EVENT_KEY_DOWN) {
+        if (evt.type == SDL_EVENT_WINDOW_FOCUS_LOST) controleur_entrees_vider(entrees);
+        if (evt.type == SDL_EVENT_KEY_UP) entrees->maintenues &= ~entree_touche(evt.key.key);
+        if (evt.type == SDL_EVENT_KEY_DOWN && !evt.key.repeat) {
             SDL_Keycode k = evt.key.key;
+            unsigned bit = entree_touche(k);
 
-            if (k == g_bindings.gauche || k == SDLK_LEFT || k == SDLK_A) {
-                controleur_appliquer_commande(e, CMD_GAUCHE);
-            } else if (k == g_bindings.droite || k == SDLK_RIGHT || k == SDLK_D) {
-                controleur_appliquer_commande(e, CMD_DROITE);
-            } else if (k == g_bindings.tirer || k == SDLK_SPACE) {
-                controleur_appliquer_commande(e, CMD_TIRER);
+            if (bit) {
+                entrees->maintenues |= bit;
+                entrees->appuyees |= bit;
             } else if (k == g_bindings.pause) {
                 if (!afficher_pause(contexte, e)) return 0;
+                /* les relâchements ont été consommés par l'écran de pause */
+                controleur_entrees_vider(entrees);
+                return 2;
             } else if (k == g_bindings.quitter) {
                 controleur_appliquer_commande(e, CMD_QUITTER);
                 return 0;
@@ -179,8 +356,31 @@ static int traiter_evenements(ContexteSDL* contexte, EtatJeu* e) {
     return 1;
 }
 
+/* Textes du bandeau, gardés entre les images */
+typedef struct {
+    int niveau, score; /* valeurs affichées (-1 : pas encore formatées) */
+    char niveau_texte[32], score_texte[32];
+} TexteHud;
+
+/* Niveau en haut au centre, score en haut à droite : les chaînes ne sont
+ * reformatées que si la valeur change, et leurs textures viennent du cache
+ * de libellés */
+static void afficher_bandeau(SDL_Renderer* rendu, TexteHud* hud, int niveau, int score, int largeur_fenetre) {
+    if (niveau != hud->niveau) {
+        hud->niveau = niveau;
+        snprintf(hud->niveau_texte, sizeof(hud->niveau_texte), "LEVEL %d", hud->niveau);
+    }
+    if (score != hud->score) {
+        hud->score = score;
+        snprintf(hud->score_texte, sizeof(hud->score_texte), "SCORE %d", hud->score);
+    }
+    SDL_Color couleur_blanche = {255, 255, 255, 255};
+    bitmap_draw_text(rendu, largeur_fenetre / 2 - 40, 10, hud->niveau_texte, couleur_blanche);
+    bitmap_draw_text(rendu, largeur_fenetre - 150, 10, hud->score_texte, couleur_blanche);
+}
+
 /* Affichage des éléments du jeu */
-static void afficher_jeu(SDL_Renderer* rendu, EtatJeu* e,
+static void afficher_jeu(SDL_Renderer* rendu, LotsImage* lots, TexteHud* hud, const RenderSnapshot* capture,
                          int largeur_jeu, int hauteur_jeu) {
     /* Fond noir */
     SDL_SetRenderDrawColor(rendu, 0, 0, 0, 255);
@@ -191,130 +391,262 @@ static void afficher_jeu(SDL_Renderer* rendu, EtatJeu* e,
     SDL_GetRenderOutputSize(rendu, &largeur_fenetre, &hauteur_fenetre);
     float largeur_cellule = (float)largeur_fenetre / largeur_jeu;
     float hauteur_cellule = (float)hauteur_fenetre / hauteur_jeu;
+    int l = (int)largeur_cellule;
+    int h = (int)hauteur_cellule;
+    if (l < 1) l = 1;
+    if (h < 1) h = 1;
 
-    /* Dessiner les ennemis */
-    int nombre_ennemis = etatjeu_obtenir_nombre_ennemis(e);
-    for (int idx = 0; idx < nombre_ennemis; ++idx) {
-        if (!etatjeu_ennemi_vivant(e, idx)) continue;
-        int ennemi_x = etatjeu_obtenir_ennemi_x(e, idx);
-        int ennemi_y = etatjeu_obtenir_ennemi_y(e, idx);
-        int sante = etatjeu_obtenir_ennemi_sante(e, idx);
-        int x_pixel = (int)(ennemi_x * largeur_cellule);
-        int y_pixel = (int)(ennemi_y * hauteur_cellule);
-        int l = (int)largeur_cellule;
-        int h = (int)hauteur_cellule;
-        if (l < 1) l = 1;
-        if (h < 1) h = 1;
-        /* Ennemis forts (sante >= 2) en rouge, normaux en orange */
-        SDL_Color couleur_ennemi = (sante >= 2) ? couleur_rouge : couleur_orange;
-        dessiner_rectangle(rendu, x_pixel, y_pixel, l, h, couleur_ennemi);
+    /* interpolation : chaque entité est dessinée entre sa position du tick
+     * précédent et celle du dernier tick, selon la fraction de pas écoulée */
+    float retard = 1.0f - (float)capture->alpha;
+
+    /* Ennemis forts (sante >= 2) en rouge, normaux en orange */
+    for (int idx = 0; idx < capture->nb_ennemis; ++idx) {
+        const EntiteRendu* ennemi = &capture->ennemis[idx];
+        int x_pixel = (int)((ennemi->x - ennemi->dx * retard) * largeur_cellule);
+        int y_pixel = (int)((ennemi->y - ennemi->dy * retard) * hauteur_cellule);
+        lot_ajouter(lots, ennemi->valeur >= 2 ? LOT_ROUGE : LOT_ORANGE, x_pixel, y_pixel, l, h);
     }
 
-    /* Dessiner les boucliers */
-    int nombre_boucliers = etatjeu_obtenir_nombre_boucliers(e);
-    for (int idx = 0; idx < nombre_boucliers; ++idx) {
-        if (!etatjeu_bouclier_vivant(e, idx)) continue;
-        int bouclier_x = etatjeu_obtenir_bouclier_x(e, idx);
-        int bouclier_y = etatjeu_obtenir_bouclier_y(e, idx);
-        int x_pixel = (int)(bouclier_x * largeur_cellule);
-        int y_pixel = (int)(bouclier_y * hauteur_cellule);
-        int l = (int)largeur_cellule;
-        int h = (int)hauteur_cellule;
-        if (l < 1) l = 1;
-        if (h < 1) h = 1;
-        dessiner_rectangle(rendu, x_pixel, y_pixel, l, h, couleur_vert);
+    /* Boucliers */
+    for (int idx = 0; idx < capture->nb_boucliers; ++idx) {
+        const EntiteRendu* bouclier = &capture->boucliers[idx];
+        int x_pixel = (int)((bouclier->x - bouclier->dx * retard) * largeur_cellule);
+        int y_pixel = (int)((bouclier->y - bouclier->dy * retard) * hauteur_cellule);
+        lot_ajouter(lots, LOT_VERT, x_pixel, y_pixel, l, h);
     }
 
-    /* Dessiner les projectiles */
-    int nombre_projectiles = etatjeu_obtenir_nombre_projectiles(e);
-    for (int idx = 0; idx < nombre_projectiles; ++idx) {
-        int proj_x = etatjeu_obtenir_projectile_x(e, idx);
-        int proj_y = etatjeu_obtenir_projectile_y(e, idx);
-        int proprietaire = etatjeu_obtenir_projectile_proprietaire(e, idx);
-        int x_pixel = (int)(proj_x * largeur_cellule);
-        int y_pixel = (int)(proj_y * hauteur_cellule);
-        int l = (int)(largeur_cellule * 0.5f); /* projectile plus petit */
-        int h = (int)(hauteur_cellule);
-        if (l < 1) l = 1;
-        if (h < 1) h = 1;
-        SDL_Color couleur_proj = (proprietaire == 0) ? couleur_jaune : couleur_magenta;
-        dessiner_rectangle(rendu, x_pixel + (int)(largeur_cellule * 0.25f), y_pixel, l, h, couleur_proj);
+    /* Projectiles, plus étroits qu'une case */
+    int l_proj = (int)(largeur_cellule * 0.5f);
+    if (l_proj < 1) l_proj = 1;
+    for (int idx = 0; idx < capture->nb_projectiles; ++idx) {
+        const EntiteRendu* proj = &capture->projectiles[idx];
+        int x_pixel = (int)((proj->x - proj->dx * retard) * largeur_cellule);
+        int y_pixel = (int)((proj->y - proj->dy * retard) * hauteur_cellule);
+        lot_ajouter(lots, proj->type == 0 ? LOT_JAUNE : LOT_MAGENTA,
+                    x_pixel + (int)(largeur_cellule * 0.25f), y_pixel, l_proj, h);
     }
 
-    /* Dessiner les particules d'explosion */
-    int nombre_particules = etatjeu_obtenir_nombre_particules(e);
-    for (int idx = 0; idx < nombre_particules; ++idx) {
-        int part_x = etatjeu_obtenir_particule_x(e, idx);
-        int part_y = etatjeu_obtenir_particule_y(e, idx);
-        int part_type = etatjeu_obtenir_particule_type(e, idx);
-        int part_ttl = etatjeu_obtenir_particule_ttl(e, idx);
-        int x_pixel = (int)(part_x * largeur_cellule);
-        int y_pixel = (int)(part_y * hauteur_cellule);
-        int taille = (int)(largeur_cellule * 0.3f);
-        if (taille < 1) taille = 1;
-        
+    /* Particules d'explosion */
+    int taille = (int)(largeur_cellule * 0.3f);
+    if (taille < 1) taille = 1;
+    for (int idx = 0; idx < capture->nb_particules; ++idx) {
+        const EntiteRendu* part = &capture->particules[idx];
+        int x_pixel = (int)((part->x - part->dx * retard) * largeur_cellule);
+        int y_pixel = (int)((part->y - part->dy * retard) * hauteur_cellule);
+
         /* Choisir la couleur selon le type d'entité */
         SDL_Color couleur_particule;
-        if (part_type == TYPE_ENNEMI_FAIBLE) couleur_particule = couleur_orange;
-        else if (part_type == TYPE_ENNEMI_FORT) couleur_particule = couleur_rouge;
-        else if (part_type == TYPE_BOUCLIER) couleur_particule = couleur_vert;
+        if (part->type == TYPE_ENNEMI_FAIBLE) couleur_particule = couleur_orange;
+        else if (part->type == TYPE_ENNEMI_FORT) couleur_particule = couleur_rouge;
+        else if (part->type == TYPE_BOUCLIER) couleur_particule = couleur_vert;
         else couleur_particule = couleur_cyan; /* joueur */
-        
+
         /* Réduire l'opacité avec le temps */
-        couleur_particule.a = (Uint8)((part_ttl / 20.0f) * 255);
-        dessiner_rectangle(rendu, x_pixel, y_pixel, taille, taille, couleur_particule);
+        couleur_particule.a = (Uint8)((part->valeur / 20.0f) * 255);
+        lot_particule(lots, x_pixel, y_pixel, taille, couleur_particule);
     }
 
-    /* Dessiner le vaisseau */
-    int vaisseau_x = etatjeu_obtenir_vaisseau_x(e);
-    int vaisseau_y = hauteur_jeu - 2;
-    int x_pixel = (int)(vaisseau_x * largeur_cellule);
-    int y_pixel = (int)(vaisseau_y * hauteur_cellule);
-    int l = (int)largeur_cellule;
-    int h = (int)(hauteur_cellule * 1.5f);
-    if (l < 1) l = 1;
-    if (h < 1) h = 1;
-    dessiner_rectangle(rendu, x_pixel, y_pixel, l, h, couleur_cyan);
+    /* Vaisseau */
+    int h_vaisseau = (int)(hauteur_cellule * 1.5f);
+    if (h_vaisseau < 1) h_vaisseau = 1;
+    lot_ajouter(lots, LOT_CYAN, (int)(capture->vaisseau_x * largeur_cellule),
+                (int)(capture->vaisseau_y * hauteur_cellule), l, h_vaisseau);
+
+    /* Vies : petits carrés en haut à gauche */
+    for (int i = 0; i < capture->vies && i < LOT_VIES_MAX; ++i) {
+        lot_ajouter(lots, LOT_CYAN, 10 + i * 25, 10, 20, 20);
+    }
+
+    lots_soumettre(rendu, lots);
+    afficher_bandeau(rendu, hud, capture->niveau, capture->score, largeur_fenetre);
+}
+
+/*
+ * Terrain en texture : le calque du modèle (un code CASE_* par case) est
+ * rastérisé dans un tampon RGBA gardé côté CPU, `pixels_case` x
+ * `pixels_case` pixels par case. Seules les cases modifiées sont repeintes,
+ * et seul le rectangle qui les contient est copié dans la texture streaming
+ * (`SDL_LockTexture`). Le terrain part en un seul `SDL_RenderTexture`
+ * étiré sur la fenêtre, quel que soit le nombre d'entités. Différences avec
+ * les rectangles : pas d'interpolation (chaque entité est dans sa case du
+ * dernier tick), et les particules, sans durée de vie dans le calque, sont
+ * rouges et opaques au lieu de prendre la couleur de leur origine et de
+ * s'estomper.
+ */
+typedef struct {
+    SDL_Texture* texture;
+    Uint32* pixels;                     /* largeur x hauteur, RGBA8888 */
+    int largeur, hauteur;               /* en pixels */
+    int pixels_case;
+    int complete;                       /* 0 : tout le tampon reste à envoyer */
+    Uint32 couleurs[CASE_NOMBRE_CODES]; /* couleur de chaque code CASE_* */
+} TerrainTexture;
+
+static Uint32 pixel_rgba(SDL_Color c) {
+    return ((Uint32)c.r << 24) | ((Uint32)c.g << 16) | ((Uint32)c.b << 8) | (Uint32)c.a;
+}
+
+static void terrain_liberer(TerrainTexture* t) {
+    if (t->texture) SDL_DestroyTexture(t->texture);
+    free(t->pixels);
+    memset(t, 0, sizeof(*t));
+}
+
+/* @return 0 si succès, 1 si la texture ou le tampon ne peuvent être créés */
+static int terrain_allouer(TerrainTexture* t, SDL_Renderer* rendu, int largeur_jeu, int hauteur_jeu, int pixels_case) {
+    memset(t, 0, sizeof(*t));
+    t->pixels_case = pixels_case;
+    t->largeur = largeur_jeu * pixels_case;
+    t->hauteur = hauteur_jeu * pixels_case;
+    t->pixels = (Uint32*)malloc(sizeof(Uint32) * (size_t)t->largeur * (size_t)t->hauteur);
+    t->texture = SDL_CreateTexture(rendu, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                   t->largeur, t->hauteur);
+    if (!t->pixels || !t->texture) {
+        terrain_liberer(t);
+        return 1;
+    }
+    /* une case garde ses bords nets une fois étirée */
+    SDL_SetTextureScaleMode(t->texture, SDL_SCALEMODE_NEAREST);
+
+    SDL_Color noir = {0, 0, 0, 255};
+    t->couleurs[CASE_VIDE] = pixel_rgba(noir);
+    t->couleurs[CASE_ENNEMI] = pixel_rgba(couleur_orange);
+    t->couleurs[CASE_TIR_JOUEUR] = pixel_rgba(couleur_jaune);
+    t->couleurs[CASE_TIR_ENNEMI] = pixel_rgba(couleur_magenta);
+    t->couleurs[CASE_BOUCLIER] = pixel_rgba(couleur_vert);
+    t->couleurs[CASE_PARTICULE] = pixel_rgba(couleur_rouge);
+    t->couleurs[CASE_VAISSEAU] = pixel_rgba(couleur_cyan);
+    t->couleurs[CASE_ENNEMI_FORT] = pixel_rgba(couleur_rouge);
+    for (size_t i = 0; i < (size_t)t->largeur * (size_t)t->hauteur; ++i) t->pixels[i] = t->couleurs[CASE_VIDE];
+    return 0;
+}
+
+/* Peint une case : fond, puis la forme de son code. Comme dans
+ * `afficher_jeu`, un tir occupe la moitié centrale de la case et une
+ * particule un carré de 0,3 case. */
+static void terrain_peindre_case(TerrainTexture* t, int cx, int cy, int code) {
+    const int p = t->pixels_case;
+    if (code >= CASE_NOMBRE_CODES) code = CASE_VIDE;
+    int x0 = 0, x1 = p, y1 = p;
+    if (code == CASE_TIR_JOUEUR || code == CASE_TIR_ENNEMI) {
+        x0 = p / 4;
+        x1 = x0 + (p / 2 > 0 ? p / 2 : 1);
+    } else if (code == CASE_PARTICULE) {
+        x1 = y1 = (p * 3) / 10 > 0 ? (p * 3) / 10 : 1;
+    }
+    const Uint32 fond = t->couleurs[CASE_VIDE];
+    const Uint32 forme = t->couleurs[code];
+    Uint32* ligne = t->pixels + (size_t)cy * p * t->largeur + (size_t)cx * p;
+    for (int y = 0; y < p; ++y, ligne += t->largeur) {
+        for (int x = 0; x < p; ++x) ligne[x] = (y < y1 && x >= x0 && x < x1) ? forme : fond;
+    }
+}
+
+/* Repeint les cases modifiées du calque et envoie à la texture le
+ * rectangle qui les contient, en un seul verrou.
+ * @return 0 si succès, -1 si le calque ne peut être alloué. */
+static int terrain_actualiser(TerrainTexture* t, EtatJeu* e) {
+    if (etatjeu_calque_actualiser(e) < 0) return -1;
+    const uint8_t* calque = etatjeu_calque(e);
+    const int p = t->pixels_case;
+    const int largeur_jeu = t->largeur / p;
+
+    /* rectangle des cases modifiées, en cases : [x0, x1) x [y0, y1) */
+    int x0 = largeur_jeu, x1 = 0, y0 = t->hauteur / p, y1 = 0;
+    CurseurPlages plages = { 0, 0 };
+    PlageModifiee plage;
+    while (etatjeu_plage_suivante(e, &plages, &plage)) {
+        const uint8_t* codes = calque + (size_t)plage.y * largeur_jeu;
+        for (int x = plage.x0; x < plage.x1; ++x) terrain_peindre_case(t, x, plage.y, codes[x]);
+        if (plage.x0 < x0) x0 = plage.x0;
+        if (plage.x1 > x1) x1 = plage.x1;
+        if (plage.y < y0) y0 = plage.y;
+        if (plage.y + 1 > y1) y1 = plage.y + 1;
+    }
+    etatjeu_calque_acquitter(e);
+
+    /* le contenu d'une texture verrouillée n'est pas garanti : la première
+     * fois, tout le tampon part */
+    if (!t->complete) {
+        x0 = 0;
+        y0 = 0;
+        x1 = largeur_jeu;
+        y1 = t->hauteur / p;
+        t->complete = 1;
+    }
+    if (x1 <= x0 || y1 <= y0) return 0;
+
+    SDL_Rect zone = { x0 * p, y0 * p, (x1 - x0) * p, (y1 - y0) * p };
+    void* cible;
+    int pas;
+    if (!SDL_LockTexture(t->texture, &zone, &cible, &pas)) return 0;
+    const size_t octets = sizeof(Uint32) * (size_t)zone.w;
+    const Uint32* source = t->pixels + (size_t)zone.y * t->largeur + zone.x;
+    for (int y = 0; y < zone.h; ++y)
+        memcpy((Uint8*)cible + (size_t)y * pas, source + (size_t)y * t->largeur, octets);
+    SDL_UnlockTexture(t->texture);
+    return 0;
+}
+
+/* Affichage du jeu par la texture du terrain : le terrain, puis les vies
+ * et le bandeau par-dessus comme dans `afficher_jeu` */
+static int afficher_jeu_texture(SDL_Renderer* rendu, TerrainTexture* terrain, LotsImage* lots, TexteHud* hud, EtatJeu* e) {
+    if (terrain_actualiser(terrain, e) != 0) return -1;
+
+    SDL_SetRenderDrawColor(rendu, 0, 0, 0, 255);
+    SDL_RenderClear(rendu);
+    SDL_RenderTexture(rendu, terrain->texture, NULL, NULL);
 
-    /* Afficher les vies (petits carrés en haut à gauche) */
+    int largeur_fenetre, hauteur_fenetre;
+    SDL_GetRenderOutputSize(rendu, &largeur_fenetre, &hauteur_fenetre);
     int vies = etatjeu_obtenir_vies(e);
-    for (int i = 0; i < vies; ++i) {
-        dessiner_rectangle(rendu, 10 + i * 25, 10, 20, 20, couleur_cyan);
+    for (int i = 0; i < vies && i < LOT_VIES_MAX; ++i) {
+        lot_ajouter(lots, LOT_CYAN, 10 + i * 25, 10, 20, 20);
     }
-    
-    /* Afficher le niveau en haut au centre */
-    int niveau = etatjeu_obtenir_niveau(e);
-    char niveau_texte[32];
-    snprintf(niveau_texte, sizeof(niveau_texte), "LEVEL %d", niveau);
-    SDL_Color couleur_blanche = {255, 255, 255, 255};
-    bitmap_draw_text(rendu, largeur_fenetre / 2 - 40, 10, niveau_texte, couleur_blanche);
-    
-    /* Afficher le score en chiffres en haut à droite */
-    int score = etatjeu_obtenir_score(e);
-    char score_texte[32];
-    snprintf(score_texte, sizeof(score_texte), "SCORE %d", score);
-    bitmap_draw_text(rendu, largeur_fenetre - 150, 10, score_texte, couleur_blanche);
-
-    SDL_RenderPresent(rendu);
+    lot_soumettre(rendu, lots, LOT_CYAN, couleur_cyan);
+    afficher_bandeau(rendu, hud, etatjeu_obtenir_niveau(e), etatjeu_obtenir_score(e), largeur_fenetre);
+    return 0;
 }
 
 /* Boucle principale de la vue SDL */
-int vue_sdl_executer(EtatJeu* e) {
-    if (!e) return -1;
-
-    ContexteSDL* contexte = sdl_initialiser();
-    if (!contexte) return -1;
+int vue_sdl_executer(ContexteSDL* contexte, EtatJeu* e) {
+    if (!contexte || !e) return -1;
+    contexte->en_cours = 1;
+    vue_sdl_ecran(contexte, "Space Invaders - SDL3", 0, 0);
+
+    /* capture de l'état et lots de dessin réutilisés à chaque image */
+    RenderSnapshot capture;
+    LotsImage lots;
+    if (etatjeu_capture_allouer(&capture, e) != 0) return -1;
+    if (lots_allouer(&lots, &capture) != 0) {
+        etatjeu_capture_liberer(&capture);
+        return -1;
+    }
 
     const int largeur_jeu = etatjeu_obtenir_largeur(e);
-    const int hauteur_jeu = 24; /* hauteur du jeu en cellules */
+    const int hauteur_jeu = etatjeu_obtenir_hauteur(e); /* hauteur du jeu en cellules */
+
+    /* terrain en texture si demandé ; sinon, ou si la texture ne peut être
+     * créée (taille au-delà du maximum du renderer...), rectangles par lots */
+    TerrainTexture terrain;
+    int en_texture = 0;
+    if (contexte->mode_rendu == RENDU_SDL_TEXTURE) {
+        if (terrain_allouer(&terrain, contexte->rendu, largeur_jeu, hauteur_jeu, contexte->pixels_case) == 0) en_texture = 1;
+        else fprintf(stderr, "sdl : texture du terrain %d x %d impossible (%s), rendu par rectangles\n",
+                     largeur_jeu * contexte->pixels_case, hauteur_jeu * contexte->pixels_case, SDL_GetError());
+    }
 
-    const int fps_cible = 60;
-    const unsigned int temps_image = 1000 / fps_cible; /* en ms */
-    unsigned int temps_precedent = SDL_GetTicks();
+    /* l'affichage vise 60 images par seconde, mais la simulation avance en
+     * ticks fixes (PAS_FIXE) selon le temps réel : sa vitesse ne dépend pas
+     * de la cadence réellement obtenue */
+    Cadence cadence;
+    cadence_demarrer(&cadence, 60);
+    Uint64 temps_precedent = SDL_GetTicksNS();
+    EntreesTick entrees = { 0 };
+    TexteHud hud = { -1, -1, "", "" };
 
     while (contexte->en_cours && !etatjeu_devrait_quitter(e)) {
-        unsigned int temps_courant = SDL_GetTicks();
-        unsigned int temps_ecoule = temps_courant - temps_precedent;
 
         /* Si game over, afficher écran de fin et attendre choix */
         if (etatjeu_est_game_over(e)) {
@@ -377,7 +709,7 @@ int vue_sdl_executer(EtatJeu* e) {
             int text_y = box_y + (box_hauteur - btn_glyph_h) / 2;
             bitmap_draw_text_custom(contexte->rendu, text_x, text_y, msg_continue, couleur_blanche, btn_size, btn_spacing);
             
-            SDL_RenderPresent(contexte->rendu);
+            vue_sdl_presenter(contexte);
             
             /* Attendre événement */
             SDL_Event evt;
@@ -390,25 +722,40 @@ int vue_sdl_executer(EtatJeu* e) {
             continue;
         }
 
-        if (!traiter_evenements(contexte, e)) {
+        int evenements = traiter_evenements(contexte, e, &entrees);
+        if (!evenements) {
             break;
         }
 
-        /* Mise à jour du jeu */
-        etatjeu_mettre_a_jour(e, temps_ecoule / 1000.0f);
+        /* Mise à jour du jeu : le temps passé en pause n'est pas simulé */
+        Uint64 temps_courant = SDL_GetTicksNS();
+        if (evenements == 2) {
+            temps_precedent = temps_courant;
+            cadence_recaler(&cadence);
+        }
+        controleur_avancer(e, &entrees, (double)(temps_courant - temps_precedent) / 1e9);
+        temps_precedent = temps_courant;
 
         /* Affichage */
-        afficher_jeu(contexte->rendu, e, largeur_jeu, hauteur_jeu);
-
-        /* Limitation du frame rate */
-        if (temps_ecoule < temps_image) {
-            SDL_Delay(temps_image - temps_ecoule);
+        if (en_texture) {
+            if (afficher_jeu_texture(contexte->rendu, &terrain, &lots, &hud, e) != 0) break;
+        } else {
+            etatjeu_capturer(e, &capture);
+            afficher_jeu(contexte->rendu, &lots, &hud, &capture, largeur_jeu, hauteur_jeu);
         }
+        vue_sdl_presenter(contexte);
 
-        /* Mise à jour du temps pour la prochaine itération */
-        temps_precedent = temps_courant;
+        /* attente de l'échéance de l'image suivante */
+        cadence_attendre(&cadence);
     }
 
-    sdl_quitter(contexte);
+    if (en_texture) terrain_liberer(&terrain);
+    lots_liberer(&lots);
+    etatjeu_capture_liberer(&capture);
+    cadence_rapport(&cadence, "sdl", stderr);
+    BitmapTextStats texte;
+    bitmap_text_stats(&texte);
+    fprintf(stderr, "sdl : libelles %lu rasterises, %lu retrouves, %lu remplaces\n",
+            texte.rasterisations, texte.retrouves, texte.evinces);
     return 0;
 }